@@ -1,6 +1,15 @@
 // based on public domain base64 implementation written by WEI Zhicheng
 // https://github.com/zhicheng/base64/blob/master/base64.c
 
+#include <pthread.h>
+#include <string.h>
+
+#if defined(HAVE_SSE41) || defined(HAVE_AVX2)
+#include <immintrin.h>
+#endif
+
+#include "cpu.h"
+
 #include "base64.h"
 
 static const char b64url_chr[] = {
@@ -65,7 +74,7 @@ static const uint8_t b64url_rev[] = {
 	    49,  50,  51, 255, 255, 255, 255, 255
 };
 
-void b64url_enc(char *out, const uint8_t *in, size_t in_len)
+static void b64url_enc_portable(char *out, const uint8_t *in, size_t in_len)
 {
 	int s;
 	size_t i,j ;
@@ -108,7 +117,7 @@ void b64url_enc(char *out, const uint8_t *in, size_t in_len)
 	out[j] = 0;
 }
 
-ssize_t b64url_dec(uint8_t *out, size_t out_space, const char *in)
+static ssize_t b64url_dec_portable(uint8_t *out, size_t out_space, const char *in)
 {
 	int s = 0;
 	size_t j = 0;
@@ -123,6 +132,9 @@ ssize_t b64url_dec(uint8_t *out, size_t out_space, const char *in)
 			break;
 		}
 
+		if ((unsigned char)c >= sizeof(b64url_rev))
+			return -1;
+
 		uint8_t x;
 		x = b64url_rev[(unsigned char)c];
 		if (x == 255)
@@ -164,3 +176,437 @@ ssize_t b64url_dec(uint8_t *out, size_t out_space, const char *in)
 
 	return j;
 }
+
+static bool b64url_dec32_portable(uint8_t out[32], const char *in)
+{
+	char buf[B64URL_LEN32 + 1];
+
+	memcpy(buf, in, B64URL_LEN32);
+	buf[B64URL_LEN32] = 0;
+
+	return b64url_dec_portable(out, 32, buf) == 32;
+}
+
+#ifdef HAVE_SSE41
+#define SSE41 __attribute__((target("ssse3,sse4.1")))
+
+/* Vectorized coding following Muła and Lemire, "Faster Base64 Encoding and
+ * Decoding Using AVX2 Instructions": 12 bytes are spread over the 16 bytes of
+ * a register with 6 bits each, characters are translated by adding an offset
+ * looked up with pshufb from the range they fall in. */
+
+static SSE41 inline __m128i enc_reshuffle_sse41(__m128i in)
+{
+	// bytes 1 0 2 1 of each three byte group into each 32 bit lane
+	in = _mm_shuffle_epi8(in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+	__m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+	__m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+	__m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+	__m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+
+	return _mm_or_si128(t1, t3);
+}
+
+static SSE41 inline __m128i enc_translate_sse41(__m128i in)
+{
+	// offsets for 26..51 (index 0), 52..61 (1-10), 62, 63 and 0..25 (13)
+	const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+	                                      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+	                                      '-' - 62, '_' - 63, 'A', 0, 0);
+
+	__m128i idx = _mm_subs_epu8(in, _mm_set1_epi8(51));
+	__m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), in);
+	idx = _mm_or_si128(idx, _mm_and_si128(upper, _mm_set1_epi8(13)));
+
+	return _mm_add_epi8(in, _mm_shuffle_epi8(offsets, idx));
+}
+
+/* Decodes the 16 characters in in to 12 bytes at the bottom of out, returns
+ * whether they were all valid. A character is invalid if the class bit of its
+ * high nibble is set in the mask for its low nibble. */
+static SSE41 inline bool dec_block_sse41(__m128i *out, __m128i in)
+{
+	const __m128i lut_lo = _mm_setr_epi8(0x0b, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03,
+	                                     0x03, 0x03, 0x07, 0x37, 0x37, 0x35, 0x37, 0x27);
+	const __m128i lut_hi = _mm_setr_epi8(0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x08, 0x20,
+	                                     0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01);
+	// offsets by high nibble, '_' uses the slot of the never valid 0
+	const __m128i lut_roll = _mm_setr_epi8(63 - '_', 0, 62 - '-', 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a',
+	                                       0, 0, 0, 0, 0, 0, 0, 0);
+	const __m128i mask_0f = _mm_set1_epi8(0x0f);
+
+	__m128i hi = _mm_and_si128(_mm_srli_epi32(in, 4), mask_0f);
+	__m128i lo = _mm_and_si128(in, mask_0f);
+
+	bool valid = _mm_testz_si128(_mm_shuffle_epi8(lut_lo, lo), _mm_shuffle_epi8(lut_hi, hi));
+
+	__m128i underscore = _mm_cmpeq_epi8(in, _mm_set1_epi8('_'));
+	__m128i v = _mm_add_epi8(in, _mm_shuffle_epi8(lut_roll, _mm_andnot_si128(underscore, hi)));
+
+	// four 6 bit values into 24 bits per 32 bit lane, then drop the top bytes
+	v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+	v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+	*out = _mm_shuffle_epi8(v, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+	return valid;
+}
+
+static SSE41 void b64url_enc_sse41(char *out, const uint8_t *in, size_t in_len)
+{
+	size_t i = 0, j = 0;
+
+	// 16 bytes are loaded for every 12 encoded ones
+	for (; i + 16 <= in_len; i += 12, j += 16) {
+		__m128i v = enc_reshuffle_sse41(_mm_loadu_si128((const __m128i *)(in + i)));
+		_mm_storeu_si128((__m128i *)(out + j), enc_translate_sse41(v));
+	}
+
+	b64url_enc_portable(out + j, in + i, in_len - i);
+}
+
+/* decodes the last len < 16 characters, padded with 'A' (zero) */
+static SSE41 ssize_t dec_tail_sse41(uint8_t *out, size_t out_space, const char *in, size_t len)
+{
+	size_t n = len * 6 / 8;
+
+	// the portable code has its own rules for running out of space
+	if (n > out_space)
+		return b64url_dec_portable(out, out_space, in);
+
+	if (len % 4 == 1)
+		return -1;
+
+	char buf[16];
+	uint8_t tmp[16];
+	__m128i v;
+
+	memcpy(buf, in, len);
+	memset(buf + len, 'A', sizeof(buf) - len);
+
+	bool valid = dec_block_sse41(&v, _mm_loadu_si128((const __m128i *)buf));
+	_mm_storeu_si128((__m128i *)tmp, v);
+
+	// excess bits of the last character only matter without spare space,
+	// as in b64url_dec_portable
+	if (!valid || (n == out_space && tmp[n] != 0))
+		return -1;
+
+	memcpy(out, tmp, n);
+
+	return n;
+}
+
+static SSE41 ssize_t b64url_dec_sse41(uint8_t *out, size_t out_space, const char *in)
+{
+	size_t len = strlen(in), i = 0, j = 0;
+
+	for (; i + 16 <= len && j + 12 <= out_space; i += 16, j += 12) {
+		uint8_t tmp[16];
+		__m128i v;
+
+		if (!dec_block_sse41(&v, _mm_loadu_si128((const __m128i *)(in + i))))
+			return -1;
+
+		_mm_storeu_si128((__m128i *)tmp, v);
+		memcpy(out + j, tmp, 12);
+	}
+
+	// the rest starts at a four character boundary
+	ssize_t ret;
+	if (len - i < 16)
+		ret = dec_tail_sse41(out + j, out_space - j, in + i, len - i);
+	else
+		ret = b64url_dec_portable(out + j, out_space - j, in + i);
+
+	if (ret < 0)
+		return -1;
+
+	return j + ret;
+}
+
+/* the last 11 of 43 characters, loaded with the 5 before them and shifted
+ * down, padded with 'A' (zero) */
+static SSE41 inline __m128i dec32_tail_sse41(const char *in)
+{
+	__m128i v = _mm_srli_si128(_mm_loadu_si128((const __m128i *)(in + B64URL_LEN32 - 16)), 5);
+
+	return _mm_or_si128(v, _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 'A', 'A', 'A', 'A', 'A'));
+}
+
+/* The padding decodes to zero bits after the 32 bytes, which are only zero if
+ * the last character had no excess bits set */
+static SSE41 bool b64url_dec32_sse41(uint8_t out[32], const char *in)
+{
+	uint8_t tmp[48];
+	__m128i v;
+	bool valid;
+
+	valid = dec_block_sse41(&v, _mm_loadu_si128((const __m128i *)in));
+	_mm_storeu_si128((__m128i *)tmp, v);
+	valid &= dec_block_sse41(&v, _mm_loadu_si128((const __m128i *)(in + 16)));
+	_mm_storeu_si128((__m128i *)(tmp + 12), v);
+	valid &= dec_block_sse41(&v, dec32_tail_sse41(in));
+	_mm_storeu_si128((__m128i *)(tmp + 24), v);
+
+	memcpy(out, tmp, 32);
+
+	return valid && tmp[32] == 0;
+}
+#endif
+
+#ifdef HAVE_AVX2
+#define AVX2 __attribute__((target("avx2")))
+
+/* the SSE4.1 code on two 128 bit lanes, 24 bytes and 32 characters at once */
+
+static AVX2 inline __m256i enc_block_avx2(const uint8_t *in)
+{
+	__m256i in2 = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)in)),
+	                                      _mm_loadu_si128((const __m128i *)(in + 12)), 1);
+
+	in2 = _mm256_shuffle_epi8(in2, _mm256_setr_epi8(
+		1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+		1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+	));
+
+	__m256i t0 = _mm256_and_si256(in2, _mm256_set1_epi32(0x0fc0fc00));
+	__m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+	__m256i t2 = _mm256_and_si256(in2, _mm256_set1_epi32(0x003f03f0));
+	__m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+	__m256i v = _mm256_or_si256(t1, t3);
+
+	const __m256i offsets = _mm256_setr_epi8(
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0,
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0
+	);
+
+	__m256i idx = _mm256_subs_epu8(v, _mm256_set1_epi8(51));
+	__m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), v);
+	idx = _mm256_or_si256(idx, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+
+	return _mm256_add_epi8(v, _mm256_shuffle_epi8(offsets, idx));
+}
+
+/* decodes 32 characters to 24 bytes at the bottom of out, see dec_block_sse41 */
+static AVX2 inline bool dec_block_avx2(__m256i *out, __m256i in)
+{
+	const __m256i lut_lo = _mm256_setr_epi8(
+		0x0b, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x07, 0x37, 0x37, 0x35, 0x37, 0x27,
+		0x0b, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x07, 0x37, 0x37, 0x35, 0x37, 0x27
+	);
+	const __m256i lut_hi = _mm256_setr_epi8(
+		0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x08, 0x20, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+		0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x08, 0x20, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01
+	);
+	const __m256i lut_roll = _mm256_setr_epi8(
+		63 - '_', 0, 62 - '-', 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a', 0, 0, 0, 0, 0, 0, 0, 0,
+		63 - '_', 0, 62 - '-', 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a', 0, 0, 0, 0, 0, 0, 0, 0
+	);
+	const __m256i mask_0f = _mm256_set1_epi8(0x0f);
+
+	__m256i hi = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask_0f);
+	__m256i lo = _mm256_and_si256(in, mask_0f);
+
+	bool valid = _mm256_testz_si256(_mm256_shuffle_epi8(lut_lo, lo), _mm256_shuffle_epi8(lut_hi, hi));
+
+	__m256i underscore = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('_'));
+	__m256i v = _mm256_add_epi8(in, _mm256_shuffle_epi8(lut_roll, _mm256_andnot_si256(underscore, hi)));
+
+	v = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+	v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+	v = _mm256_shuffle_epi8(v, _mm256_setr_epi8(
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+	));
+	*out = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+
+	return valid;
+}
+
+static AVX2 void b64url_enc_avx2(char *out, const uint8_t *in, size_t in_len)
+{
+	size_t i = 0, j = 0;
+
+	// the upper 12 bytes are loaded from in + 12 with 16 bytes
+	for (; i + 28 <= in_len; i += 24, j += 32)
+		_mm256_storeu_si256((__m256i *)(out + j), enc_block_avx2(in + i));
+
+	b64url_enc_sse41(out + j, in + i, in_len - i);
+}
+
+static AVX2 ssize_t b64url_dec_avx2(uint8_t *out, size_t out_space, const char *in)
+{
+	size_t len = strlen(in), i = 0, j = 0;
+
+	for (; i + 32 <= len && j + 24 <= out_space; i += 32, j += 24) {
+		uint8_t tmp[32];
+		__m256i v;
+
+		if (!dec_block_avx2(&v, _mm256_loadu_si256((const __m256i *)(in + i))))
+			return -1;
+
+		_mm256_storeu_si256((__m256i *)tmp, v);
+		memcpy(out + j, tmp, 24);
+	}
+
+	ssize_t ret = b64url_dec_sse41(out + j, out_space - j, in + i);
+	if (ret < 0)
+		return -1;
+
+	return j + ret;
+}
+
+/* see b64url_dec32_sse41 */
+static AVX2 bool b64url_dec32_avx2(uint8_t out[32], const char *in)
+{
+	uint8_t tmp[48];
+	__m256i v;
+	__m128i w;
+	bool valid;
+
+	valid = dec_block_avx2(&v, _mm256_loadu_si256((const __m256i *)in));
+	valid &= dec_block_sse41(&w, dec32_tail_sse41(in));
+
+	_mm256_storeu_si256((__m256i *)tmp, v);
+	_mm_storeu_si128((__m128i *)(tmp + 24), w);
+	memcpy(out, tmp, 32);
+
+	return valid && tmp[32] == 0;
+}
+#endif
+
+struct b64url_impl {
+	void (*enc)(char *out, const uint8_t *in, size_t in_len);
+	ssize_t (*dec)(uint8_t *out, size_t out_space, const char *in);
+	bool (*dec32)(uint8_t out[32], const char *in);
+};
+
+static const struct b64url_impl impl_portable = {
+	b64url_enc_portable, b64url_dec_portable, b64url_dec32_portable
+};
+#ifdef HAVE_SSE41
+static const struct b64url_impl impl_sse41 = {
+	b64url_enc_sse41, b64url_dec_sse41, b64url_dec32_sse41
+};
+#endif
+#ifdef HAVE_AVX2
+static const struct b64url_impl impl_avx2 = {
+	b64url_enc_avx2, b64url_dec_avx2, b64url_dec32_avx2
+};
+#endif
+
+// selected by b64url_dispatch, or for the CPU on the first call
+static const struct b64url_impl *impl = &impl_portable;
+static pthread_once_t dispatch_once = PTHREAD_ONCE_INIT;
+
+static int dispatch_select(unsigned int cpu);
+
+static void dispatch_load(void)
+{
+	dispatch_select(cpu_features());
+}
+
+void b64url_enc(char *out, const uint8_t *in, size_t in_len)
+{
+	pthread_once(&dispatch_once, dispatch_load);
+	impl->enc(out, in, in_len);
+}
+
+ssize_t b64url_dec(uint8_t *out, size_t out_space, const char *in)
+{
+	pthread_once(&dispatch_once, dispatch_load);
+	return impl->dec(out, out_space, in);
+}
+
+size_t b64url_dec32_batch(uint8_t (*out)[32], bool *valid, const char *const *in, size_t count)
+{
+	size_t n = 0;
+
+	pthread_once(&dispatch_once, dispatch_load);
+
+	for (size_t i = 0; i < count; i++) {
+		valid[i] = impl->dec32(out[i], in[i]);
+		n += valid[i];
+	}
+
+	return n;
+}
+
+/* checks the given implementation against known answers, and against the
+ * portable code for a 32 byte value and invalid characters */
+static int b64url_selftest(const struct b64url_impl *test)
+{
+	// RFC4648, Section 10
+	static const uint8_t raw[6] = "foobar";
+	static const char enc[] = "Zm9vYmFy";
+
+	char out_enc[sizeof(enc)];
+	uint8_t out_raw[sizeof(raw)];
+
+	test->enc(out_enc, raw, sizeof(raw));
+	if (memcmp(out_enc, enc, sizeof(enc)) != 0)
+		return -1;
+
+	if (test->dec(out_raw, sizeof(out_raw), enc) != sizeof(raw) || memcmp(out_raw, raw, sizeof(raw)) != 0)
+		return -1;
+
+	uint8_t raw32[32], out32[32];
+	char enc32[B64URL_LEN32 + 1], out_enc32[B64URL_LEN32 + 1];
+
+	// covers all 64 characters
+	for (int i = 0; i < 32; i++)
+		raw32[i] = i * 8 + (i >> 2);
+
+	b64url_enc_portable(enc32, raw32, sizeof(raw32));
+	test->enc(out_enc32, raw32, sizeof(raw32));
+	if (memcmp(out_enc32, enc32, sizeof(enc32)) != 0)
+		return -1;
+
+	if (test->dec(out32, sizeof(out32), enc32) != sizeof(out32) || memcmp(out32, raw32, sizeof(raw32)) != 0)
+		return -1;
+
+	memset(out32, 0, sizeof(out32));
+	if (!test->dec32(out32, enc32) || memcmp(out32, raw32, sizeof(raw32)) != 0)
+		return -1;
+
+	enc32[5] = '+';
+	if (test->dec(out32, sizeof(out32), enc32) != -1 || test->dec32(out32, enc32))
+		return -1;
+
+	return 0;
+}
+
+/* selects the implementation without going through impl, only the selected
+ * one is checked and the portable code is used if that fails */
+static int dispatch_select(unsigned int cpu)
+{
+	const struct b64url_impl *select = &impl_portable;
+
+#ifdef HAVE_SSE41
+	if (cpu & CPU_SSE41)
+		select = &impl_sse41;
+#endif
+#ifdef HAVE_AVX2
+	if (cpu & CPU_AVX2)
+		select = &impl_avx2;
+#endif
+
+	if (b64url_selftest(select) != 0) {
+		impl = &impl_portable;
+		return -1;
+	}
+
+	impl = select;
+	return 0;
+}
+
+int b64url_dispatch(unsigned int cpu)
+{
+	// the first call would undo this otherwise
+	pthread_once(&dispatch_once, dispatch_load);
+
+	return dispatch_select(cpu);
+}
@@ -3,6 +3,24 @@
 #include <unistd.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 void b64url_enc(char *out, const uint8_t *in, size_t in_len);
 ssize_t b64url_dec(uint8_t *out, size_t out_space, const char *in);
+
+// length of the encoding of 32 bytes (a key or challenge)
+#define B64URL_LEN32 43
+
+// decodes count encodings of 32 byte values, in[i] points to B64URL_LEN32
+// characters and does not need to be NUL terminated. valid[i] is set to
+// whether in[i] decoded like b64url_dec would have, the number of valid
+// inputs is returned.
+size_t b64url_dec32_batch(uint8_t (*out)[32], bool *valid, const char *const *in, size_t count);
+
+// selects the implementation for the given CPU features (see cpu.h) and
+// checks it against known answers. This happens for cpu_features() on the
+// first call, calling it explicitly (e.g. in tests) must not race with
+// encoding or decoding in other threads.
+//
+// Returns -1 if a self-test failed.
+int b64url_dispatch(unsigned int cpu);
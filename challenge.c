@@ -14,42 +14,63 @@
 
 #include "wordlist.h"
 
-char *response_to_code(uint8_t response[static 32], size_t digits)
+_Static_assert(32 * 8 / BITS_PER_WORD * (WORD_LEN_MAX + 1) <= RESPONSE_SIZE_MAX,
+               "RESPONSE_SIZE_MAX too small for the longest phrase");
+
+int response_to_code(const uint8_t response[static 32], size_t digits, char *out, size_t size)
 {
-	if (digits > 19)
-		return NULL;
+	if (digits > 19 || size < digits + 1)
+		return -1;
 
 	uint64_t code = unp64le(response);
 
-	char *out = malloc(digits + 1);
-	if (!out)
-		return NULL;
-
 	out[digits] = 0;
 	while (digits--) {
 		out[digits] = '0' + (code % 10);
 		code /= 10;
 	}
 
-	return out;
+	return 0;
+}
+
+void challenge_to_decimal(const uint8_t challenge[static 32], char out[static CHALLENGE_DEC_LEN + 1])
+{
+	uint32_t limbs[8];
+	for (size_t i = 0; i < 8; i++)
+		limbs[i] = unp32le(challenge + 4 * i);
+
+	// repeatedly divide by 10^9, giving 9 digits each
+	size_t pos = CHALLENGE_DEC_LEN;
+	out[pos] = 0;
+
+	while (pos > 0) {
+		uint64_t rem = 0;
+
+		for (size_t i = 8; i-- > 0;) {
+			uint64_t cur = rem << 32 | limbs[i];
+			limbs[i] = cur / 1000000000;
+			rem = cur % 1000000000;
+		}
+
+		for (size_t i = 0; i < 9 && pos > 0; i++) {
+			out[--pos] = '0' + rem % 10;
+			rem /= 10;
+		}
+	}
 }
 
-char *response_to_phrase(uint8_t response[static 32], size_t words)
+int response_to_phrase(const uint8_t response[static 32], size_t words, char *out, size_t size)
 {
 	if (words * BITS_PER_WORD > 32 * 8)
-		return NULL;
+		return -1;
 
-	if (words == 0)
-		return NULL;
+	if (words == 0 || size < words * (WORD_LEN_MAX + 1))
+		return -1;
 
 	uint32_t buffer, buffer_fill;
 	buffer = 0;
 	buffer_fill = 0;
 
-	char *out = malloc(words * (WORD_LEN_MAX + 1));
-	if (!out)
-		return NULL;
-
 	char *p = out;
 
 	for (size_t i = 0; i < words; i++) {
@@ -64,10 +85,11 @@ char *response_to_phrase(uint8_t response[static 32], size_t words)
 		buffer >>= BITS_PER_WORD;
 		buffer_fill -= BITS_PER_WORD;
 
-		const char *word = wordlist[word_idx];
-		size_t word_len = strlen(word);
+		// each word has WORD_LEN_MAX + 1 bytes in out, so the whole row can
+		// be copied
+		size_t word_len = wordlist_len[word_idx];
 
-		memcpy(p, word, word_len);
+		memcpy(p, wordlist[word_idx], WORD_LEN_MAX);
 		p[word_len] = ' ';
 
 		p += word_len + 1;
@@ -75,10 +97,47 @@ char *response_to_phrase(uint8_t response[static 32], size_t words)
 
 	*(p - 1) = 0;
 
-	return out;
+	return 0;
 }
 
-int make_challenge(const uint8_t pubkey[static 32],
+void make_response(const uint8_t dh_shared[static 32], const char **payload,
+                   uint8_t response_out[static 32])
+{
+	// login data is usually short enough for hmac_short
+	uint8_t login_data[HMAC_SHORT_MAX];
+	size_t login_len = 0;
+
+	for (const char **p = payload; *p; p++) {
+		size_t len = strlen(*p) + 1;
+
+		if (len > sizeof(login_data) - login_len) {
+			login_len = SIZE_MAX;
+			break;
+		}
+
+		memcpy(login_data + login_len, *p, len);
+		login_len += len;
+	}
+
+	if (login_len != SIZE_MAX) {
+		hmac_short(response_out, dh_shared, login_data, login_len);
+	} else {
+		struct hmac_state hmac;
+		hmac_init(&hmac, dh_shared, 32);
+
+		while (*payload) {
+			const char *p = *payload;
+
+			hmac_process(&hmac, (const uint8_t*)p, strlen(p) + 1);
+
+			payload++;
+		}
+
+		hmac_finish(&hmac, response_out);
+	}
+}
+
+int make_challenge(const uint8_t pubkey[static 32], const void *pubkey_table,
                    const char **payload,
                    uint8_t challenge_out[static 32], uint8_t response_out[static 32])
 {
@@ -86,26 +145,102 @@ int make_challenge(const uint8_t pubkey[static 32],
 	if (randombytes(secret, sizeof(secret)) < 0)
 		return -1;
 
-	crypto_scalarmult_base(challenge_out, secret);
-
 	uint8_t dh_shared[32];
-	crypto_scalarmult(dh_shared, secret, pubkey);
+	crypto_scalarmult_base_pair(challenge_out, dh_shared, secret, pubkey, pubkey_table);
 
-	struct hmac_state hmac;
-	hmac_init(&hmac, dh_shared, sizeof(dh_shared));
+	make_response(dh_shared, payload, response_out);
 
-	while (*payload) {
-		const char *p = *payload;
+	wipe_sized(dh_shared);
+	wipe_sized(secret);
 
-		hmac_process(&hmac, (const uint8_t*)p, strlen(p) + 1);
+	return 0;
+}
 
-		payload++;
-	}
+int challenge_begin(struct pending_challenge *pending, uint8_t challenge_out[static 32])
+{
+	if (randombytes(pending->secret, sizeof(pending->secret)) < 0)
+		return -1;
+
+	crypto_scalarmult_base(challenge_out, pending->secret);
 
-	hmac_finish(&hmac, response_out);
+	return 0;
+}
+
+int challenge_respond(struct pending_challenge *pending,
+                      const uint8_t pubkey[static 32], const void *pubkey_table,
+                      const char **payload, uint8_t response_out[static 32])
+{
+	uint8_t dh_shared[32];
+
+	if (!pubkey_table || crypto_scalarmult_table(dh_shared, pending->secret, pubkey_table) < 0)
+		crypto_scalarmult(dh_shared, pending->secret, pubkey);
+
+	make_response(dh_shared, payload, response_out);
 
 	wipe_sized(dh_shared);
-	wipe_sized(secret);
+	wipe_ref(pending);
 
 	return 0;
 }
+
+int make_responses(const uint8_t privkey[static 32], const uint8_t *challenges,
+                   const char **const *payloads, uint8_t (*responses_out)[32], size_t count)
+{
+	int ret = -1;
+	size_t total_len = 0, dh_size, data_size, data_len_size;
+
+	if (count == 0)
+		return 0;
+
+	for (size_t i = 0; i < count; i++) {
+		for (const char **p = payloads[i]; *p; p++) {
+			if (__builtin_add_overflow(total_len, strlen(*p) + 1, &total_len)) {
+				errno = ENOMEM;
+				return -1;
+			}
+		}
+	}
+
+	if (__builtin_mul_overflow(count, 32, &dh_size) ||
+	    __builtin_mul_overflow(count, sizeof(const uint8_t *), &data_size) ||
+	    __builtin_mul_overflow(count, sizeof(size_t), &data_len_size)) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	uint8_t *dh_shared = malloc(dh_size);
+	uint8_t *login_data = malloc(total_len ? total_len : 1);
+	const uint8_t **data = malloc(data_size);
+	size_t *data_len = malloc(data_len_size);
+	if (!dh_shared || !login_data || !data || !data_len)
+		goto out;
+
+	// the payload of each challenge as a single message, see make_challenge
+	uint8_t *d = login_data;
+	for (size_t i = 0; i < count; i++) {
+		data[i] = d;
+
+		for (const char **p = payloads[i]; *p; p++) {
+			size_t len = strlen(*p) + 1;
+
+			memcpy(d, *p, len);
+			d += len;
+		}
+
+		data_len[i] = d - data[i];
+	}
+
+	crypto_scalarmult_batch(dh_shared, privkey, challenges, count);
+	hmac_batch(responses_out, dh_shared, 32, data, data_len, count);
+
+	wipe(dh_shared, dh_size);
+	ret = 0;
+
+out:
+	free(dh_shared);
+	free(login_data);
+	free(data);
+	free(data_len);
+
+	return ret;
+}
@@ -3,9 +3,46 @@
 #include <stdint.h>
 #include <stddef.h>
 
-char *response_to_phrase(uint8_t response[static 32], size_t words);
-char *response_to_code(uint8_t response[static 32], size_t digits);
+// large enough for the output of response_to_phrase and response_to_code
+#define RESPONSE_SIZE_MAX 208
 
-int make_challenge(const uint8_t pubkey[static 32],
+// write the NUL terminated response to out, -1 if the length is unsupported
+// or out too small
+int response_to_phrase(const uint8_t response[static 32], size_t words, char *out, size_t size);
+int response_to_code(const uint8_t response[static 32], size_t digits, char *out, size_t size);
+
+// length of the fixed width decimal encoding of a challenge, 2^256 - 1 has 78
+// digits
+#define CHALLENGE_DEC_LEN 78
+
+// writes the challenge as a little endian number of CHALLENGE_DEC_LEN decimal
+// digits (with leading zeros) and a NUL to out
+void challenge_to_decimal(const uint8_t challenge[static 32], char out[static CHALLENGE_DEC_LEN + 1]);
+
+// pubkey_table is an optional crypto_scalarmult_table table for pubkey
+int make_challenge(const uint8_t pubkey[static 32], const void *pubkey_table,
                    const char **payload,
                    uint8_t challenge_out[static 32], uint8_t response_out[static 32]);
+
+// the response for a DH secret computed elsewhere (e.g. by pbotpd)
+void make_response(const uint8_t dh_shared[static 32], const char **payload,
+                   uint8_t response_out[static 32]);
+
+// make_challenge in two steps, so that the response can be computed while the
+// challenge is shown: challenge_begin only computes the challenge from a fresh
+// nonce, challenge_respond the response and wipes the nonce
+struct pending_challenge {
+	uint8_t secret[32];
+};
+
+int challenge_begin(struct pending_challenge *pending, uint8_t challenge_out[static 32]);
+int challenge_respond(struct pending_challenge *pending,
+                      const uint8_t pubkey[static 32], const void *pubkey_table,
+                      const char **payload, uint8_t response_out[static 32]);
+
+// server side of make_challenge: responses_out[i] for the challenge at
+// challenges + 32 * i and the NULL terminated payloads[i], computed in batches.
+// Returns -1 with errno set if the buffers cannot be allocated. Only the tests
+// use it so far, it is meant for bulk responders.
+int make_responses(const uint8_t privkey[static 32], const uint8_t *challenges,
+                   const char **const *payloads, uint8_t (*responses_out)[32], size_t count);
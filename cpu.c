@@ -0,0 +1,73 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include "cpu.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+static unsigned int cpu_detect(void)
+{
+	unsigned int eax, ebx, ecx, edx, features = 0;
+	unsigned int max_leaf = __get_cpuid_max(0, NULL);
+
+	if (max_leaf < 1)
+		return 0;
+
+	__cpuid(1, eax, ebx, ecx, edx);
+	bool osxsave = ecx & bit_OSXSAVE;
+	bool sse41 = (ecx & bit_SSSE3) && (ecx & bit_SSE4_1);
+
+	if (sse41)
+		features |= CPU_SSE41;
+
+	// leaf 7 is missing on CPUs with SSE4.1 only (e.g. Penryn, Nehalem)
+	if (max_leaf < 7)
+		return features;
+
+	__cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+	if ((ebx & bit_BMI2) && (ebx & bit_ADX))
+		features |= CPU_BMI2_ADX;
+
+	if (sse41 && (ebx & bit_SHA))
+		features |= CPU_SHA;
+
+	// AVX2 also needs the OS to save the YMM registers
+	if (osxsave && (ebx & bit_AVX2)) {
+		uint32_t xcr0_lo, xcr0_hi;
+
+		__asm__ ("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+		if ((xcr0_lo & 6) == 6)
+			features |= CPU_AVX2;
+	}
+
+	return features;
+}
+#else
+static unsigned int cpu_detect(void)
+{
+	return 0;
+}
+#endif
+
+static unsigned int features;
+static pthread_once_t features_once = PTHREAD_ONCE_INIT;
+
+static void features_load(void)
+{
+	if (getenv("PBOTP_PORTABLE") == NULL)
+		features = cpu_detect();
+}
+
+unsigned int cpu_features(void)
+{
+	pthread_once(&features_once, features_load);
+
+	return features;
+}
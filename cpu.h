@@ -0,0 +1,12 @@
+#pragma once
+
+// CPU features that accelerated backends depend on, each backend is selected
+// and self-tested on the first call of a primitive, see the *_dispatch functions
+
+#define CPU_AVX2     (1u << 0)
+#define CPU_BMI2_ADX (1u << 1)
+#define CPU_SHA      (1u << 2)  // SHA extensions along with SSSE3 and SSE4.1
+#define CPU_SSE41    (1u << 3)  // SSSE3 and SSE4.1
+
+// none if PBOTP_PORTABLE is set in the environment, to force the portable code
+unsigned int cpu_features(void);
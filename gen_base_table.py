@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+
+# Generates the fixed-base table used by crypto_scalarmult_base.
+#
+# X25519 with base point u = 9 is computed on the birationally equivalent
+# twisted Edwards curve -x^2 + y^2 = 1 + d x^2 y^2 (the Ed25519 curve), where
+# u = 9 corresponds to the usual Ed25519 base point B with y = 4/5.
+#
+# The table holds (j + 1) * 256^i * B for i = 0..31 and j = 0..7 in the affine
+# "precomp" representation (y + x, y - x, 2 d x y) with each coordinate split
+# into limbs for the respective field backend.
+
+import sys
+
+P = 2**255 - 19
+D = (-121665 * pow(121666, P - 2, P)) % P
+
+def inv(x):
+    return pow(x, P - 2, P)
+
+def sqrt(x):
+    r = pow(x, (P + 3) // 8, P)
+    if (r * r - x) % P != 0:
+        r = r * pow(2, (P - 1) // 4, P) % P
+    assert (r * r - x) % P == 0
+    return r
+
+def add(p, q):
+    x1, y1 = p
+    x2, y2 = q
+    t = D * x1 * x2 * y1 * y2 % P
+    x3 = (x1 * y2 + x2 * y1) * inv(1 + t) % P
+    y3 = (y1 * y2 + x1 * x2) * inv(1 - t) % P
+    return (x3, y3)
+
+def base_point():
+    y = 4 * inv(5) % P
+    x = sqrt((y * y - 1) * inv(D * y * y + 1))
+    if x & 1:
+        x = P - x
+    return (x, y)
+
+def limbs(v, bits, count):
+    return [(v >> (bits * i)) & ((1 << bits) - 1) for i in range(count)]
+
+BACKENDS = {
+    # name: (limb C type, bits per limb, limb count)
+    'fe51': ('uint64_t', 51, 5),
+}
+
+def main():
+    if len(sys.argv) != 2 or sys.argv[1] not in BACKENDS:
+        sys.stderr.write('usage: %s {%s}\n' % (sys.argv[0], '|'.join(BACKENDS)))
+        sys.exit(1)
+
+    ctype, bits, count = BACKENDS[sys.argv[1]]
+
+    def fe(v):
+        return '{' + ', '.join('0x%x' % l for l in limbs(v, bits, count)) + '}'
+
+    print('// generated by gen_base_table.py, do not edit')
+    print()
+    print('static const %s base_table[32][8][3][%d] = {' % (ctype, count))
+
+    row = base_point()
+    for i in range(32):
+        print('\t{')
+        p = row
+        for j in range(8):
+            x, y = p
+            print('\t\t{ %s, %s, %s },' % (fe((y + x) % P), fe((y - x) % P), fe(2 * D * x * y % P)))
+            p = add(p, row)
+
+        print('\t},')
+
+        for _ in range(8):
+            row = add(row, row)
+
+    print('};')
+
+if __name__ == '__main__':
+    main()
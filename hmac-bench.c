@@ -0,0 +1,69 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "hmac.h"
+
+#define ROUNDS 20000
+#define REPEAT 20
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* best time per call in ns out of REPEAT runs, the output feeds the next key
+ * so that no call can be skipped */
+static double bench(bool use_short, uint8_t key[static 32], const uint8_t *msg, size_t len)
+{
+	double best = 1e9;
+	uint8_t out[SHA256_SIZE];
+
+	for (int r = 0; r < REPEAT; r++) {
+		double t = now();
+
+		for (int i = 0; i < ROUNDS; i++) {
+			if (use_short)
+				hmac_short(out, key, msg, len);
+			else
+				hmac(out, key, 32, msg, len);
+
+			key[0] ^= out[0];
+		}
+
+		t = (now() - t) * 1e9 / ROUNDS;
+		if (t < best)
+			best = t;
+	}
+
+	return best;
+}
+
+// compares hmac() and hmac_short() for the key and message sizes of a response
+int main(void)
+{
+	static const size_t lens[] = { 0, 23, 40, HMAC_SHORT_MAX };
+	uint8_t key[32], msg[HMAC_SHORT_MAX];
+
+	for (size_t i = 0; i < sizeof(key); i++)
+		key[i] = i;
+	for (size_t i = 0; i < sizeof(msg); i++)
+		msg[i] = i;
+
+	printf("%8s %14s %16s\n", "length", "hmac [ns]", "hmac_short [ns]");
+
+	for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+		double t_hmac = bench(false, key, msg, lens[l]);
+		double t_short = bench(true, key, msg, lens[l]);
+
+		printf("%8zu %14.1f %16.1f\n", lens[l], t_hmac, t_short);
+	}
+
+	return EXIT_SUCCESS;
+}
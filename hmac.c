@@ -1,20 +1,27 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
+#include <assert.h>
 
 #include "utils.h"
 
 #include "hmac.h"
 
-void hmac_init(struct hmac_state *hmac,
-               const uint8_t *key, size_t key_len)
+static void hmac_expand_key(uint8_t key_exp[SHA256_BLOCK_SIZE],
+                            const uint8_t *key, size_t key_len)
 {
-	memset(&hmac->key_exp, 0, SHA256_BLOCK_SIZE);
+	memset(key_exp, 0, SHA256_BLOCK_SIZE);
 
 	if (key_len <= SHA256_BLOCK_SIZE)
-		memcpy(hmac->key_exp, key, key_len);
+		memcpy(key_exp, key, key_len);
 	else
-		sha256(hmac->key_exp, key, key_len);
+		sha256(key_exp, key, key_len);
+}
+
+void hmac_init(struct hmac_state *hmac,
+               const uint8_t *key, size_t key_len)
+{
+	hmac_expand_key(hmac->key_exp, key, key_len);
 
 	uint8_t key_pad[SHA256_BLOCK_SIZE];
 	for (size_t i = 0; i < SHA256_BLOCK_SIZE; i++)
@@ -62,3 +69,102 @@ void hmac(uint8_t *hmac_out,
 	hmac_process(&hmac, data, data_len);
 	hmac_finish(&hmac, hmac_out); // wipes &hmac
 }
+
+void hmac_short(uint8_t *hmac_out, const uint8_t key[static 32],
+                const uint8_t *data, size_t data_len)
+{
+	// the outer message always is the 64 byte key block and the 32 byte
+	// inner hash, so the padding after the hash is constant
+	static const uint8_t outer_pad[SHA256_BLOCK_SIZE - SHA256_SIZE] = {
+		0x80, [30] = (96 * 8) >> 8, [31] = (96 * 8) & 0xff
+	};
+
+	struct sha256_state md;
+	uint8_t block[SHA256_BLOCK_SIZE];
+
+	assert(data_len <= HMAC_SHORT_MAX);
+
+	sha256_init(&md);
+	memset(block + 32, 0x36, SHA256_BLOCK_SIZE - 32);
+	for (size_t i = 0; i < 32; i++)
+		block[i] = key[i] ^ 0x36;
+	sha256_process_block(&md, block);
+
+	memcpy(block, data, data_len);
+	block[data_len] = 0x80;
+	memset(block + data_len + 1, 0, SHA256_BLOCK_SIZE - 8 - (data_len + 1));
+	p64be(block + SHA256_BLOCK_SIZE - 8, (SHA256_BLOCK_SIZE + data_len) * 8);
+	sha256_process_block(&md, block);
+
+	// the inner hash goes into the second outer block right away
+	uint8_t hash_inner[SHA256_BLOCK_SIZE];
+	for (int i = 0; i < 8; i++)
+		p32be(hash_inner + 4*i, md.state[i]);
+	memcpy(hash_inner + SHA256_SIZE, outer_pad, sizeof(outer_pad));
+
+	sha256_init(&md);
+	memset(block + 32, 0x5c, SHA256_BLOCK_SIZE - 32);
+	for (size_t i = 0; i < 32; i++)
+		block[i] = key[i] ^ 0x5c;
+	sha256_process_block(&md, block);
+	sha256_process_block(&md, hash_inner);
+
+	// md.state is the result now, nothing secret is left in md
+	for (int i = 0; i < 8; i++)
+		p32be(hmac_out + 4*i, md.state[i]);
+
+	wipe_sized(block);
+	wipe(hash_inner, SHA256_SIZE);
+}
+
+void hmac_batch(uint8_t (*hmac_out)[SHA256_SIZE],
+                const uint8_t *keys, size_t key_len,
+                const uint8_t *const *data, const size_t *data_len, size_t count)
+{
+	for (size_t base = 0; base < count; base += SHA256_LANES) {
+		size_t lanes = MIN(count - base, SHA256_LANES);
+		uint8_t key_exp[SHA256_LANES][SHA256_BLOCK_SIZE];
+		uint8_t key_pad[SHA256_LANES][SHA256_BLOCK_SIZE];
+		uint8_t hash_inner[SHA256_LANES][SHA256_SIZE];
+		struct sha256_state md[SHA256_LANES];
+		const uint8_t *in[SHA256_LANES];
+		size_t len[SHA256_LANES];
+
+		for (size_t l = 0; l < lanes; l++) {
+			hmac_expand_key(key_exp[l], keys + (base + l) * key_len, key_len);
+
+			for (size_t i = 0; i < SHA256_BLOCK_SIZE; i++)
+				key_pad[l][i] = key_exp[l][i] ^ 0x36;
+
+			sha256_init(&md[l]);
+			in[l] = key_pad[l];
+			len[l] = SHA256_BLOCK_SIZE;
+		}
+
+		sha256_process_batch(md, in, len, lanes);
+		sha256_process_batch(md, &data[base], &data_len[base], lanes);
+		sha256_finish_batch(md, hash_inner, lanes);
+
+		for (size_t l = 0; l < lanes; l++) {
+			for (size_t i = 0; i < SHA256_BLOCK_SIZE; i++)
+				key_pad[l][i] = key_exp[l][i] ^ 0x5c;
+
+			sha256_init(&md[l]);
+		}
+
+		sha256_process_batch(md, in, len, lanes);
+
+		for (size_t l = 0; l < lanes; l++) {
+			in[l] = hash_inner[l];
+			len[l] = SHA256_SIZE;
+		}
+
+		sha256_process_batch(md, in, len, lanes);
+		sha256_finish_batch(md, &hmac_out[base], lanes);
+
+		wipe_sized(key_exp);
+		wipe_sized(key_pad);
+		wipe_sized(hash_inner);
+		wipe_sized(md);
+	}
+}
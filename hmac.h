@@ -19,3 +19,20 @@ void hmac_finish(struct hmac_state *hmac, uint8_t *hmac_out);
 void hmac(uint8_t *hmac_out,
           const uint8_t *key, size_t key_len,
           const uint8_t *data, size_t data_len);
+
+// longest message hmac_short accepts, it has to fit in a single block along
+// with the padding
+#define HMAC_SHORT_MAX (SHA256_BLOCK_SIZE - 9)
+
+// hmac() for a 32 byte key and at most HMAC_SHORT_MAX bytes of data, which
+// builds the four padded blocks directly
+void hmac_short(uint8_t *hmac_out, const uint8_t key[static 32],
+                const uint8_t *data, size_t data_len);
+
+// hmac_out[i] = HMAC(key i, data[i]) for count messages, the keys are stored
+// back to back in keys (key_len bytes each, e.g. the output of
+// crypto_scalarmult_batch). The hashes are computed in parallel, see
+// sha256_process_batch.
+void hmac_batch(uint8_t (*hmac_out)[SHA256_SIZE],
+                const uint8_t *keys, size_t key_len,
+                const uint8_t *const *data, const size_t *data_len, size_t count);
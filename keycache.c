@@ -0,0 +1,192 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "base64.h"
+#include "tweetnacl.h"
+#include "utils.h"
+
+#include "keycache.h"
+
+/* The cache file holds the crypto_scalarmult_table table for one public key.
+ * Its contents are not secret, but whoever can write it controls the DH
+ * secret of every login, so only files that can only have been written by
+ * root are accepted. */
+
+#define KEYCACHE_MAGIC "pbotpkc1"
+
+struct keycache_header {
+	char magic[8];
+	uint32_t table_size;
+	uint32_t reserved;
+	uint8_t pubkey[32];
+	uint8_t pad[16];
+};
+
+_Static_assert(sizeof(struct keycache_header) == 64, "unexpected header size");
+
+#define KEYCACHE_SIZE (sizeof(struct keycache_header) + CRYPTO_SCALARMULT_TABLE_BYTES)
+
+static int cache_path(char *out, size_t size, const char *dir, const uint8_t pubkey[static 32])
+{
+	char name[44];
+	b64url_enc(name, pubkey, 32);
+
+	if (xsnprintf(out, size, "%s/%s.tbl", dir, name) < 0) {
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	return 0;
+}
+
+static const void *map_cache(const char *path, const uint8_t pubkey[static 32])
+{
+	int fd = open(path, O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+	if (fd < 0)
+		return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) < 0) {
+		close(fd);
+		return NULL;
+	}
+
+	if (!S_ISREG(st.st_mode) || st.st_uid != 0 || (st.st_mode & (S_IWGRP | S_IWOTH))) {
+		close(fd);
+		errno = EPERM;
+		return NULL;
+	}
+
+	if ((size_t)st.st_size != KEYCACHE_SIZE) {
+		close(fd);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	void *p = mmap(NULL, KEYCACHE_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (p == MAP_FAILED)
+		return NULL;
+
+	const struct keycache_header *hdr = p;
+	if (memcmp(hdr->magic, KEYCACHE_MAGIC, sizeof(hdr->magic)) != 0 ||
+	    hdr->table_size != CRYPTO_SCALARMULT_TABLE_BYTES ||
+	    memcmp(hdr->pubkey, pubkey, 32) != 0) {
+		munmap(p, KEYCACHE_SIZE);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	return (const uint8_t*)p + sizeof(*hdr);
+}
+
+static int create_cache(const char *path, const uint8_t pubkey[static 32])
+{
+	if (geteuid() != 0) {
+		errno = EPERM;
+		return -1;
+	}
+
+	AUTOFREE_BUF(uint8_t, buf, KEYCACHE_SIZE);
+	if (!buf)
+		return -1;
+
+	struct keycache_header *hdr = (struct keycache_header*)buf;
+	memcpy(hdr->magic, KEYCACHE_MAGIC, sizeof(hdr->magic));
+	hdr->table_size = CRYPTO_SCALARMULT_TABLE_BYTES;
+	memcpy(hdr->pubkey, pubkey, 32);
+
+	if (crypto_scalarmult_table_init(buf + sizeof(*hdr), pubkey) < 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	char tmp_path[PATH_MAX];
+	if (xsnprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", path) < 0) {
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	int fd = mkstemp(tmp_path);
+	if (fd < 0)
+		return -1;
+
+	if (fchmod(fd, 0644) < 0)
+		goto fail;
+
+	const uint8_t *p = buf;
+	size_t left = KEYCACHE_SIZE;
+	while (left) {
+		ssize_t ret = write(fd, p, left);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+
+			goto fail;
+		}
+
+		p += ret;
+		left -= ret;
+	}
+
+	if (close(fd) < 0) {
+		fd = -1;
+		goto fail;
+	}
+
+	// concurrent logins may race to create the file, the last one wins
+	if (rename(tmp_path, path) < 0) {
+		int saved_errno = errno;
+		unlink(tmp_path);
+		errno = saved_errno;
+		return -1;
+	}
+
+	return 0;
+
+fail:
+	{
+		int saved_errno = errno;
+		if (fd >= 0)
+			close(fd);
+		unlink(tmp_path);
+		errno = saved_errno;
+	}
+
+	return -1;
+}
+
+const void *keycache_open(const char *dir, const uint8_t pubkey[static 32])
+{
+	if (CRYPTO_SCALARMULT_TABLE_BYTES == 0) {
+		errno = ENOTSUP;
+		return NULL;
+	}
+
+	char path[PATH_MAX];
+	if (cache_path(path, sizeof(path), dir, pubkey) < 0)
+		return NULL;
+
+	const void *table = map_cache(path, pubkey);
+	if (table || errno != ENOENT)
+		return table;
+
+	if (create_cache(path, pubkey) < 0)
+		return NULL;
+
+	return map_cache(path, pubkey);
+}
+
+void keycache_close(const void *table)
+{
+	munmap((uint8_t*)table - sizeof(struct keycache_header), KEYCACHE_SIZE);
+}
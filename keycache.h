@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdint.h>
+
+const void *keycache_open(const char *dir, const uint8_t pubkey[static 32]);
+void keycache_close(const void *table);
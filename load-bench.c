@@ -0,0 +1,130 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <dlfcn.h>
+#include <link.h>
+
+#define ROUNDS 200
+#define REPEAT 10
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* sum of a field (e.g. "Private_Dirty:") in kB over all mappings of path */
+static long smaps_kb(const char *path, const char *field)
+{
+	FILE *f = fopen("/proc/self/smaps", "r");
+	if (!f)
+		return -1;
+
+	char line[PATH_MAX + 128];
+	bool in_module = false;
+	long total = 0;
+
+	while (fgets(line, sizeof(line), f)) {
+		// mapping headers start with the address range, fields with a name
+		if (strchr(line, '-') && strchr(line, '-') < strchr(line, ' ')) {
+			line[strcspn(line, "\n")] = 0;
+			const char *name = strchr(line, '/');
+			in_module = name && strcmp(name, path) == 0;
+		} else if (in_module && strncmp(line, field, strlen(field)) == 0) {
+			total += strtol(line + strlen(field), NULL, 10);
+		}
+	}
+
+	fclose(f);
+
+	return total;
+}
+
+struct segments {
+	const char *path;
+	size_t writable, relro;
+};
+
+static int find_segments(struct dl_phdr_info *info, size_t size, void *arg)
+{
+	(void) size;
+
+	struct segments *seg = arg;
+	if (strcmp(info->dlpi_name, seg->path) != 0)
+		return 0;
+
+	for (int i = 0; i < info->dlpi_phnum; i++) {
+		const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+
+		if (ph->p_type == PT_LOAD && (ph->p_flags & PF_W))
+			seg->writable += ph->p_memsz;
+		else if (ph->p_type == PT_GNU_RELRO)
+			seg->relro += ph->p_memsz;
+	}
+
+	return 1;
+}
+
+// what every process loading the PAM module pays: dlopen (with all relocations
+// processed) and dlclose time, and the pages of the module it dirties
+int main(int argc, char **argv)
+{
+	char path[PATH_MAX];
+	if (!realpath(argc > 1 ? argv[1] : MODULE_PATH, path)) {
+		perror("resolving module path failed");
+		return EXIT_FAILURE;
+	}
+
+	// keep the dependencies loaded so that only the module itself is measured
+	if (!dlopen("libpam.so.0", RTLD_NOW | RTLD_GLOBAL)) {
+		fprintf(stderr, "loading libpam failed: %s\n", dlerror());
+		return EXIT_FAILURE;
+	}
+
+	double best = 1e9;
+
+	for (int r = 0; r < REPEAT; r++) {
+		double t = now();
+
+		for (int i = 0; i < ROUNDS; i++) {
+			void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+			if (!handle) {
+				fprintf(stderr, "loading %s failed: %s\n", path, dlerror());
+				return EXIT_FAILURE;
+			}
+
+			dlclose(handle);
+		}
+
+		t = (now() - t) * 1e6 / ROUNDS;
+		if (t < best)
+			best = t;
+	}
+
+	void *handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if (!handle) {
+		fprintf(stderr, "loading %s failed: %s\n", path, dlerror());
+		return EXIT_FAILURE;
+	}
+
+	// the writable segments (including the part that is made read-only
+	// after relocation) are private to each process
+	struct segments seg = { .path = path };
+	dl_iterate_phdr(find_segments, &seg);
+
+	printf("load+unload: %.1f us\n", best);
+	printf("writable segments: %zu bytes (relro: %zu bytes)\n", seg.writable, seg.relro);
+	printf("private dirty: %ld kB\n", smaps_kb(path, "Private_Dirty:"));
+	printf("rss: %ld kB\n", smaps_kb(path, "Rss:"));
+
+	dlclose(handle);
+
+	return EXIT_SUCCESS;
+}
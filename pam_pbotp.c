@@ -2,11 +2,13 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <stdbool.h>
 #include <sys/utsname.h>
 #include <limits.h>
 #include <errno.h>
 #include <syslog.h>
+#include <pthread.h>
 
 #include <security/_pam_macros.h>
 #include <security/pam_ext.h>
@@ -16,6 +18,9 @@
 
 #include "base64.h"
 #include "challenge.h"
+#include "keycache.h"
+#include "pbotpd.h"
+#include "pool.h"
 #include "utils.h"
 
 #ifdef HAVE_QR
@@ -24,6 +29,12 @@
 
 #define EXPORT_SYMBOL __attribute__((visibility("default")))
 
+/* Per authentication scratch space: the response job, the URL, the QR code
+ * (below 5 KiB), its line buffer (below 1 KiB) and the message holding all of
+ * it (below 12 KiB in utf8 and ascii mode, larger ansi codes are sent line by
+ * line). */
+#define ARENA_SIZE 32768
+
 enum response_mode {
 	RESPONSE_CODE,
 	RESPONSE_PHRASE
@@ -34,22 +45,33 @@ static const char *response_mode_name[] = {
 	[RESPONSE_PHRASE] = "phrase"
 };
 
+enum url_format {
+	URL_BASE64,
+	URL_COMPACT
+};
+
 struct context {
 	struct pam_handle *pamh;
 
 	const char *baseurl;
 	const char *group;
+	const char *group_alias;
 	char hostname[HOST_NAME_MAX];
 	const char *user;
 
 	uint8_t pubkey[32];
+	const char *cache_dir;
+	const char *daemon_socket;
+	const char *pool_file;
 
 #ifdef HAVE_QR
 	bool qr_enabled;
+	bool qr_lines;
 	enum qr_mode qr_mode;
 #endif
 
 	enum response_mode response_mode;
+	enum url_format url_format;
 	unsigned int length;
 };
 
@@ -74,8 +96,16 @@ static int parse_args(struct context *ctx, int argc, const char **argv)
 			pubkey_set = true;
 		} else if ((p = startswith(argv[i], "group="))) {
 			ctx->group= p;
+		} else if ((p = startswith(argv[i], "group_alias="))) {
+			ctx->group_alias = p;
 		} else if ((p = startswith(argv[i], "baseurl="))) {
 			ctx->baseurl = p;
+		} else if ((p = startswith(argv[i], "cache_dir="))) {
+			ctx->cache_dir = p;
+		} else if ((p = startswith(argv[i], "daemon_socket="))) {
+			ctx->daemon_socket = p;
+		} else if ((p = startswith(argv[i], "pool_file="))) {
+			ctx->pool_file = p;
 		} else if ((p = startswith(argv[i], "response_mode="))) {
 			if (streq(p, "code")) {
 				ctx->response_mode = RESPONSE_CODE;
@@ -85,6 +115,15 @@ static int parse_args(struct context *ctx, int argc, const char **argv)
 				pam_syslog(ctx->pamh, LOG_ERR, "unknown response mode: '%s'", p);
 				return -1;
 			}
+		} else if ((p = startswith(argv[i], "url_format="))) {
+			if (streq(p, "base64")) {
+				ctx->url_format = URL_BASE64;
+			} else if (streq(p, "compact")) {
+				ctx->url_format = URL_COMPACT;
+			} else {
+				pam_syslog(ctx->pamh, LOG_ERR, "unknown URL format: '%s'", p);
+				return -1;
+			}
 #ifdef HAVE_QR
 		} else if ((p = startswith(argv[i], "qr="))) {
 			if (streq(p, "utf8")) {
@@ -93,12 +132,16 @@ static int parse_args(struct context *ctx, int argc, const char **argv)
 				ctx->qr_mode = QR_MODE_ANSI;
 			} else if (streq(p, "ascii")) {
 				ctx->qr_mode = QR_MODE_ASCII;
+			} else if (streq(p, "braille")) {
+				ctx->qr_mode = QR_MODE_BRAILLE;
 			} else if (streq(p, "none")) {
 				ctx->qr_enabled = false;
 			} else {
 				pam_syslog(ctx->pamh, LOG_ERR, "unknown QR code mode: '%s'", p);
 				return -1;
 			}
+		} else if (streq(argv[i], "qr_lines")) {
+			ctx->qr_lines = true;
 #endif
 		} else if ((p = startswith(argv[i], "length="))) {
 			int tmp;
@@ -167,65 +210,201 @@ static void print_wrapper(const char *str, void *arg)
 
 	pam_info(ctx->pamh, "%s", str);
 }
+
+/* Shows the QR code for url in a single message, which saves a conversation
+ * round trip per line. Falls back to one message per line if qr_lines is set,
+ * the message doesn't fit in arena or the conversation function rejects it. */
+static void output_qr(struct context *ctx, const char *url, struct arena *arena)
+{
+	static const char header[] = "Scan this QR code to get a login token\n";
+	static const char url_prefix[] = "\nOr go to this URL: ";
+
+	struct qrcode *qr = encode_qr(url, arena);
+
+	if (qr && !ctx->qr_lines) {
+		char *msg = NULL;
+
+		char *footer = arena_alloc(arena, strlen(url_prefix) + strlen(url) + 1);
+		if (footer) {
+			stpcpy(stpcpy(footer, url_prefix), url);
+			msg = format_qr(qr, ctx->qr_mode, header, footer, arena);
+		}
+
+		if (msg && pam_info(ctx->pamh, "%s", msg) == PAM_SUCCESS)
+			return;
+	}
+
+	pam_info(ctx->pamh, "%s", header);
+	if (!qr || print_qr(qr, ctx->qr_mode, arena, print_wrapper, ctx) < 0)
+		pam_info(ctx->pamh, "Could not generate QR code\n");
+
+	pam_info(ctx->pamh, "%s%s", url_prefix, url);
+}
 #endif
 
-static char *format_response(struct context *ctx, uint8_t response_raw[static 32])
+static int format_response(struct context *ctx, const uint8_t response_raw[static 32],
+                           char out[static RESPONSE_SIZE_MAX])
 {
 	switch (ctx->response_mode) {
 		case RESPONSE_CODE:
-			return response_to_code(response_raw, ctx->length);
+			return response_to_code(response_raw, ctx->length, out, RESPONSE_SIZE_MAX);
 		case RESPONSE_PHRASE:
-			return response_to_phrase(response_raw, ctx->length);
+			return response_to_phrase(response_raw, ctx->length, out, RESPONSE_SIZE_MAX);
 	}
 
+	return -1;
+}
+
+/* The DH secret, HMAC and formatting of the expected response, which is only
+ * needed after the user entered theirs. It runs on a worker thread while the
+ * challenge is shown (or synchronously if that thread can't be started). With
+ * a precomputed challenge it is already done when the challenge is shown. */
+struct response_job {
+	struct context *ctx;
+	const void *pubkey_table;
+	const char *payload[4];
+	struct pending_challenge pending;
+
+	pthread_t thread;
+	bool threaded;
+	bool done;
+
+	int ret;
+	char expected_response[RESPONSE_SIZE_MAX];
+};
+
+static void run_response_job(struct response_job *job)
+{
+	uint8_t response_raw[32];
+
+	job->ret = challenge_respond(&job->pending, job->ctx->pubkey, job->pubkey_table,
+	                             job->payload, response_raw);
+	if (job->ret == 0)
+		job->ret = format_response(job->ctx, response_raw, job->expected_response);
+
+	wipe_sized(response_raw);
+}
+
+static void *response_worker(void *arg)
+{
+	run_response_job(arg);
+
 	return NULL;
 }
 
-static int output_challenge(struct context *ctx, char **expected_response)
+/* waits for the job and returns the expected response, NULL on errors */
+static const char *finish_response_job(struct response_job *job)
 {
-	const char *elements[] = {
-		ctx->baseurl,
-		ctx->group,
-		ctx->hostname,
-		ctx->user,
-		NULL,
-		NULL
-	};
+	if (job->threaded)
+		pthread_join(job->thread, NULL);
+	else if (!job->done)
+		run_response_job(job);
 
-	uint8_t challenge_raw[32];
-	uint8_t response_raw[32];
-	if (make_challenge(ctx->pubkey, &elements[1], challenge_raw, response_raw) < 0) {
-		pam_syslog(ctx->pamh, LOG_ERR, "generating challenge failed");
-		return -1;
+	if (job->pubkey_table)
+		keycache_close(job->pubkey_table);
+
+	wipe_sized(job->pending);
+
+	if (job->ret < 0) {
+		pam_syslog(job->ctx->pamh, LOG_ERR, "computing response failed");
+		return NULL;
 	}
 
-	char challenge[44];
-	b64url_enc(challenge, challenge_raw, 32);
+	return job->expected_response;
+}
+
+/* takes a precomputed challenge from pbotpd or the pool file, which leaves
+ * only the HMAC to do here, returns -1 if there is none */
+static int claim_challenge(struct context *ctx, struct response_job *job,
+                           uint8_t challenge_out[static 32])
+{
+	uint8_t dh_shared[32], response_raw[32];
+	int ret = -1;
+
+	if (!ctx->daemon_socket && !ctx->pool_file)
+		return -1;
+
+	if (ctx->daemon_socket)
+		ret = pbotpd_claim(ctx->daemon_socket, ctx->pubkey, challenge_out, dh_shared);
 
-	elements[ARRAY_SIZE(elements)-2] = challenge;
+	if (ret < 0 && ctx->pool_file)
+		ret = pool_claim(ctx->pool_file, ctx->pubkey, challenge_out, dh_shared);
 
-	*expected_response = format_response(ctx, response_raw);
-	if (!*expected_response) {
-		pam_syslog(ctx->pamh, LOG_ERR, "formatting response failed");
+	if (ret < 0) {
+		pam_syslog(ctx->pamh, LOG_DEBUG, "no precomputed challenge, computing it inline");
 		return -1;
 	}
 
-	AUTOFREE_PTR(char, url);
-	url = join(elements, '/');
-	if (!url) {
+	make_response(dh_shared, job->payload, response_raw);
+	job->ret = format_response(ctx, response_raw, job->expected_response);
+	job->done = true;
+
+	wipe_sized(dh_shared);
+	wipe_sized(response_raw);
+
+	return 0;
+}
+
+/* shows the challenge and starts computing the response in job, which needs
+ * to be finished with finish_response_job on success */
+static int output_challenge(struct context *ctx, struct response_job *job, struct arena *arena)
+{
+	job->ctx = ctx;
+	job->payload[0] = ctx->group;
+	job->payload[1] = ctx->hostname;
+	job->payload[2] = ctx->user;
+
+	uint8_t challenge_raw[32];
+	if (claim_challenge(ctx, job, challenge_raw) < 0) {
+		if (challenge_begin(&job->pending, challenge_raw) < 0) {
+			pam_syslog(ctx->pamh, LOG_ERR, "generating challenge failed");
+			return -1;
+		}
+
+		if (ctx->cache_dir) {
+			job->pubkey_table = keycache_open(ctx->cache_dir, ctx->pubkey);
+			if (!job->pubkey_table)
+				pam_syslog(ctx->pamh, LOG_WARNING, "could not use pubkey cache in %s: %s",
+				           ctx->cache_dir, strerror(errno));
+		}
+
+		job->threaded = pthread_create(&job->thread, NULL, response_worker, job) == 0;
+	}
+
+	// the compact format has the challenge in decimal, which QR codes
+	// encode in 10 bits per 3 digits instead of 8 bits per base64 character
+	char challenge[CHALLENGE_DEC_LEN + 1];
+	if (ctx->url_format == URL_COMPACT)
+		challenge_to_decimal(challenge_raw, challenge);
+	else
+		b64url_enc(challenge, challenge_raw, 32);
+
+	// the alias only stands in for the group in the URL, the response is
+	// still computed over the group
+	const char *elements[] = {
+		ctx->baseurl,
+		ctx->group_alias ? ctx->group_alias : ctx->group,
+		ctx->hostname,
+		ctx->user,
+		challenge,
+		NULL
+	};
+
+	size_t url_size = 0;
+	for (const char **elem = elements; *elem; elem++)
+		url_size += strlen(*elem) + 1;
+
+	char *url = arena_alloc(arena, url_size);
+	if (!url || join(url, url_size, elements, '/') < 0) {
 		pam_syslog(ctx->pamh, LOG_ERR, "generating URL failed");
 
-		free(*expected_response);
+		finish_response_job(job);
 		return -1;
 	}
 
 #ifdef HAVE_QR
 	if (ctx->qr_enabled) {
-		pam_info(ctx->pamh, "Scan this QR code to get a login token\n");
-		if (print_qr(url, ctx->qr_mode, print_wrapper, ctx) < 0)
-			pam_info(ctx->pamh, "Could not generate QR code\n");
-
-		pam_info(ctx->pamh, "\nOr go to this URL: %s", url);
+		output_qr(ctx, url, arena);
 	} else
 #endif
 	{
@@ -235,50 +414,31 @@ static int output_challenge(struct context *ctx, char **expected_response)
 	return 0;
 }
 
-EXPORT_SYMBOL int pam_sm_authenticate(pam_handle_t *pamh, int flags, int argc, const char **argv)
+/* shows the challenge and checks the response, everything secret lives in
+ * arena */
+static int authenticate(struct context *ctx, struct arena *arena)
 {
-	(void) flags;
-
 	int _;
-	struct context ctx;
-
-	memset(&ctx, 0, sizeof(ctx));
-
-	ctx.pamh = pamh;
-	ctx.response_mode = RESPONSE_CODE;
 
-#ifdef HAVE_QR
-	ctx.qr_enabled = true;
-	ctx.qr_mode = QR_MODE_UTF8;
-#endif
-
-	if (parse_args(&ctx, argc, argv) < 0)
+	struct response_job *job = arena_alloc(arena, sizeof(*job));
+	if (!job || output_challenge(ctx, job, arena) < 0) {
+		pam_syslog(ctx->pamh, LOG_ERR, "could not generate challenge");
 		return PAM_AUTHINFO_UNAVAIL;
-
-	if (!ctx.hostname[0]) {
-		if (gethostname(ctx.hostname, sizeof(ctx.hostname)) < 0) {
-			pam_syslog(pamh, LOG_ERR, "could not get hostname: %s", strerror(errno));
-			return PAM_AUTHINFO_UNAVAIL;
-		}
 	}
 
-	_ = pam_get_user(ctx.pamh, &ctx.user, NULL);
-	if (_ != PAM_SUCCESS) {
-		pam_syslog(ctx.pamh, LOG_ERR, "could not get user name: %s", pam_strerror(ctx.pamh, _));
-		return PAM_USER_UNKNOWN;
-	}
+	char *response;
+	_ = pam_prompt(ctx->pamh, PAM_PROMPT_ECHO_ON, &response,
+	               "Enter login %s: ", response_mode_name[ctx->response_mode]);
 
-	AUTOFREE_PTR(char, expected_response);
-	if (output_challenge(&ctx, &expected_response) < 0) {
-		pam_syslog(pamh, LOG_ERR, "could not generate challenge");
+	const char *expected_response = finish_response_job(job);
+
+	if (_ != PAM_SUCCESS) {
+		pam_syslog(ctx->pamh, LOG_ERR, "could not get token response: %s", pam_strerror(ctx->pamh, _));
 		return PAM_AUTHINFO_UNAVAIL;
 	}
 
-	char *response;
-	_ = pam_prompt(ctx.pamh, PAM_PROMPT_ECHO_ON, &response,
-	               "Enter login %s: ", response_mode_name[ctx.response_mode]);
-	if (_ != PAM_SUCCESS) {
-		pam_syslog(ctx.pamh, LOG_ERR, "could not get token response: %s", pam_strerror(ctx.pamh, _));
+	if (!expected_response) {
+		free(response);
 		return PAM_AUTHINFO_UNAVAIL;
 	}
 
@@ -298,7 +458,7 @@ EXPORT_SYMBOL int pam_sm_authenticate(pam_handle_t *pamh, int flags, int argc, c
 
 	bool equal = false;
 
-	switch (ctx.response_mode) {
+	switch (ctx->response_mode) {
 		case RESPONSE_CODE:
 			equal = streq_isgraph(response, expected_response);
 			break;
@@ -312,6 +472,51 @@ EXPORT_SYMBOL int pam_sm_authenticate(pam_handle_t *pamh, int flags, int argc, c
 	return equal ? PAM_SUCCESS : PAM_AUTH_ERR;
 }
 
+EXPORT_SYMBOL int pam_sm_authenticate(pam_handle_t *pamh, int flags, int argc, const char **argv)
+{
+	(void) flags;
+
+	int _;
+	struct context ctx;
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	ctx.pamh = pamh;
+	ctx.response_mode = RESPONSE_CODE;
+	ctx.url_format = URL_BASE64;
+
+#ifdef HAVE_QR
+	ctx.qr_enabled = true;
+	ctx.qr_mode = QR_MODE_UTF8;
+#endif
+
+	if (parse_args(&ctx, argc, argv) < 0)
+		return PAM_AUTHINFO_UNAVAIL;
+
+	if (!ctx.hostname[0]) {
+		if (gethostname(ctx.hostname, sizeof(ctx.hostname)) < 0) {
+			pam_syslog(pamh, LOG_ERR, "could not get hostname: %s", strerror(errno));
+			return PAM_AUTHINFO_UNAVAIL;
+		}
+	}
+
+	_ = pam_get_user(ctx.pamh, &ctx.user, NULL);
+	if (_ != PAM_SUCCESS) {
+		pam_syslog(ctx.pamh, LOG_ERR, "could not get user name: %s", pam_strerror(ctx.pamh, _));
+		return PAM_USER_UNKNOWN;
+	}
+
+	uint8_t arena_buf[ARENA_SIZE] __attribute__((aligned(16)));
+	struct arena arena;
+	arena_init(&arena, arena_buf, sizeof(arena_buf));
+
+	int ret = authenticate(&ctx, &arena);
+
+	arena_wipe(&arena);
+
+	return ret;
+}
+
 EXPORT_SYMBOL int pam_sm_setcred (pam_handle_t *pamh, int flags, int argc, const char **argv)
 {
 	(void) pamh;
@@ -0,0 +1,78 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "base64.h"
+#include "pool.h"
+#include "tweetnacl.h"
+
+static __attribute__((noreturn)) void help(const char *progname, int code)
+{
+	fprintf(stderr,
+		"usage: %s [-n size] poolfile pubkey\n"
+		"\n"
+		"    Fills poolfile with precomputed challenges for pubkey, to be used by\n"
+		"    pam_pbotp via its pool_file option.\n"
+		"\n"
+		"    -n size: Number of challenges to keep ready (default: 32)\n",
+		progname);
+
+	exit(code);
+}
+
+int main(int argc, char **argv)
+{
+	size_t size = 32;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "n:h")) != -1) {
+		switch (opt) {
+			case 'n':
+				size = strtoul(optarg, NULL, 10);
+				break;
+			case 'h':
+				help(argv[0], EXIT_SUCCESS);
+			default:
+				help(argv[0], EXIT_FAILURE);
+		}
+	}
+
+	if (argc - optind != 2 || size == 0)
+		help(argv[0], EXIT_FAILURE);
+
+	const char *path = argv[optind];
+	const char *key = argv[optind + 1];
+
+	uint8_t pubkey[32];
+	if (strlen(key) != B64URL_LEN32 || b64url_dec(pubkey, 32, key) != 32) {
+		fprintf(stderr, "invalid pubkey: %s\n", key);
+		return EXIT_FAILURE;
+	}
+
+	// only use otherwise idle CPU time
+	struct sched_param param = { 0 };
+	sched_setscheduler(0, SCHED_IDLE, &param);
+
+	void *table = NULL;
+	if (CRYPTO_SCALARMULT_TABLE_BYTES) {
+		table = malloc(CRYPTO_SCALARMULT_TABLE_BYTES);
+		if (table && crypto_scalarmult_table_init(table, pubkey) < 0) {
+			free(table);
+			table = NULL;
+		}
+	}
+
+	ssize_t added = pool_fill(path, pubkey, size, table);
+	free(table);
+
+	if (added < 0) {
+		fprintf(stderr, "filling %s failed: %s\n", path, strerror(errno));
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
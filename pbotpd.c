@@ -0,0 +1,293 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#include "base64.h"
+#include "tweetnacl.h"
+#include "utils.h"
+
+#include "pbotpd.h"
+
+// Keeps a pool of precomputed challenges for each configured pubkey, so that
+// logins only pay for the HMAC over their login data. The pools are filled by
+// worker threads running with the SCHED_IDLE policy, requests are served from
+// the main thread.
+
+struct entry {
+	uint8_t challenge[32];
+	uint8_t dh_shared[32];
+};
+
+struct pool {
+	uint8_t pubkey[32];
+	void *table;
+
+	struct entry *entries;
+	size_t head, fill;
+};
+
+static struct pool *pools;
+static size_t num_pools, pool_size = 64;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t need_fill = PTHREAD_COND_INITIALIZER;
+
+static __attribute__((noreturn)) void help(const char *progname, int code)
+{
+	fprintf(stderr,
+		"usage: %s [-s socket] [-n size] [-j threads] pubkey...\n"
+		"\n"
+		"    -s socket: Path of the socket to listen on (default: " PBOTPD_SOCKET ")\n"
+		"    -n size: Number of challenges to keep ready per pubkey (default: 64)\n"
+		"    -j threads: Number of threads computing challenges (default: number of CPUs)\n",
+		progname);
+
+	exit(code);
+}
+
+/* the pool with the fewest ready challenges, NULL if all are full */
+static struct pool *pool_to_fill(void)
+{
+	struct pool *best = NULL;
+
+	for (size_t i = 0; i < num_pools; i++) {
+		if (pools[i].fill < pool_size && (!best || pools[i].fill < best->fill))
+			best = &pools[i];
+	}
+
+	return best;
+}
+
+static void *fill_worker(void *arg)
+{
+	(void) arg;
+
+	// only use otherwise idle CPU time
+	struct sched_param param = { 0 };
+	pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+
+	for (;;) {
+		pthread_mutex_lock(&lock);
+
+		struct pool *pool;
+		while (!(pool = pool_to_fill()))
+			pthread_cond_wait(&need_fill, &lock);
+
+		pthread_mutex_unlock(&lock);
+
+		uint8_t secret[32];
+		struct entry e;
+
+		if (randombytes(secret, sizeof(secret)) < 0) {
+			perror("generating nonce failed");
+			exit(EXIT_FAILURE);
+		}
+
+		crypto_scalarmult_base_pair(e.challenge, e.dh_shared, secret, pool->pubkey, pool->table);
+		wipe_sized(secret);
+
+		pthread_mutex_lock(&lock);
+
+		// another worker may have filled the pool in the meantime
+		if (pool->fill < pool_size) {
+			pool->entries[(pool->head + pool->fill) % pool_size] = e;
+			pool->fill++;
+		}
+
+		pthread_mutex_unlock(&lock);
+
+		wipe_sized(e);
+	}
+
+	return NULL;
+}
+
+static void handle_client(int fd)
+{
+	struct ucred cred;
+	socklen_t cred_len = sizeof(cred);
+	if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) < 0 || cred.uid != 0)
+		return;
+
+	// requests are served one at a time, don't wait for slow clients
+	struct timeval timeout = { .tv_sec = 1 };
+	if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0 ||
+	    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) < 0)
+		return;
+
+	struct pbotpd_request req;
+	struct pbotpd_reply reply = { .status = PBOTPD_BAD_REQUEST };
+
+	if (recv(fd, &req, sizeof(req), 0) != sizeof(req))
+		return;
+
+	if (req.version == PBOTPD_VERSION) {
+		reply.status = PBOTPD_UNKNOWN_KEY;
+
+		pthread_mutex_lock(&lock);
+
+		for (size_t i = 0; i < num_pools; i++) {
+			struct pool *pool = &pools[i];
+
+			if (memcmp(pool->pubkey, req.pubkey, 32) != 0)
+				continue;
+
+			if (pool->fill == 0) {
+				reply.status = PBOTPD_EMPTY;
+				break;
+			}
+
+			struct entry *e = &pool->entries[pool->head];
+			memcpy(reply.challenge, e->challenge, 32);
+			memcpy(reply.dh_shared, e->dh_shared, 32);
+			wipe_ref(e);
+
+			pool->head = (pool->head + 1) % pool_size;
+			pool->fill--;
+			reply.status = PBOTPD_OK;
+
+			pthread_cond_signal(&need_fill);
+			break;
+		}
+
+		pthread_mutex_unlock(&lock);
+	}
+
+	send(fd, &reply, sizeof(reply), MSG_NOSIGNAL);
+	wipe_sized(reply);
+}
+
+static int listen_socket(const char *path)
+{
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		fprintf(stderr, "socket path too long: %s\n", path);
+		return -1;
+	}
+
+	strcpy(addr.sun_path, path);
+
+	int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if (fd < 0) {
+		perror("creating socket failed");
+		return -1;
+	}
+
+	// only root may connect, which is checked again for each client
+	mode_t old_umask = umask(077);
+	unlink(path);
+	int ret = bind(fd, (struct sockaddr *)&addr, sizeof(addr));
+	umask(old_umask);
+
+	if (ret < 0 || listen(fd, SOMAXCONN) < 0) {
+		fprintf(stderr, "listening on %s failed: %s\n", path, strerror(errno));
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+int main(int argc, char **argv)
+{
+	const char *socket_path = PBOTPD_SOCKET;
+	long threads = sysconf(_SC_NPROCESSORS_ONLN);
+	int opt;
+
+	while ((opt = getopt(argc, argv, "s:n:j:h")) != -1) {
+		switch (opt) {
+			case 's':
+				socket_path = optarg;
+				break;
+			case 'n':
+				pool_size = strtoul(optarg, NULL, 10);
+				break;
+			case 'j':
+				threads = strtol(optarg, NULL, 10);
+				break;
+			case 'h':
+				help(argv[0], EXIT_SUCCESS);
+			default:
+				help(argv[0], EXIT_FAILURE);
+		}
+	}
+
+	if (optind == argc || pool_size == 0 || threads <= 0)
+		help(argv[0], EXIT_FAILURE);
+
+	num_pools = argc - optind;
+	pools = calloc(num_pools, sizeof(*pools));
+	if (!pools) {
+		perror("allocating pools failed");
+		return EXIT_FAILURE;
+	}
+
+	for (size_t i = 0; i < num_pools; i++) {
+		struct pool *pool = &pools[i];
+		const char *key = argv[optind + i];
+
+		if (strlen(key) != B64URL_LEN32 || b64url_dec(pool->pubkey, 32, key) != 32) {
+			fprintf(stderr, "invalid pubkey: %s\n", key);
+			return EXIT_FAILURE;
+		}
+
+		pool->entries = calloc(pool_size, sizeof(*pool->entries));
+		if (!pool->entries) {
+			perror("allocating pool failed");
+			return EXIT_FAILURE;
+		}
+
+		// keep the DH secrets out of swap
+		if (mlock(pool->entries, pool_size * sizeof(*pool->entries)) < 0)
+			perror("warning: locking pool in memory failed");
+
+		if (CRYPTO_SCALARMULT_TABLE_BYTES) {
+			pool->table = malloc(CRYPTO_SCALARMULT_TABLE_BYTES);
+			if (pool->table && crypto_scalarmult_table_init(pool->table, pool->pubkey) < 0) {
+				free(pool->table);
+				pool->table = NULL;
+			}
+		}
+	}
+
+	int listen_fd = listen_socket(socket_path);
+	if (listen_fd < 0)
+		return EXIT_FAILURE;
+
+	for (long i = 0; i < threads; i++) {
+		pthread_t thread;
+
+		errno = pthread_create(&thread, NULL, fill_worker, NULL);
+		if (errno) {
+			perror("starting worker failed");
+			return EXIT_FAILURE;
+		}
+	}
+
+	signal(SIGPIPE, SIG_IGN);
+
+	for (;;) {
+		int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+		if (fd < 0) {
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+
+			perror("accepting connection failed");
+			return EXIT_FAILURE;
+		}
+
+		handle_client(fd);
+		close(fd);
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+// Protocol between pbotpd, which precomputes challenges, and pam_pbotp. The
+// client sends a request on a SOCK_SEQPACKET Unix socket and gets a single
+// reply. Both sides only talk to root (checked via SO_PEERCRED), since the
+// reply contains the DH secret for the challenge.
+
+#define PBOTPD_SOCKET "/run/pbotpd.sock"
+#define PBOTPD_VERSION 1
+
+enum pbotpd_status {
+	PBOTPD_OK,
+	PBOTPD_EMPTY,        // pool drained, compute the challenge inline
+	PBOTPD_UNKNOWN_KEY,  // pubkey not configured in the daemon
+	PBOTPD_BAD_REQUEST,
+};
+
+struct pbotpd_request {
+	uint8_t version;
+	uint8_t pubkey[32];
+};
+
+struct pbotpd_reply {
+	uint8_t status;
+	uint8_t challenge[32];
+	uint8_t dh_shared[32];
+};
+
+// claims a precomputed challenge for pubkey from the daemon listening on path,
+// returns -1 if there is none (no daemon, empty pool, ...)
+int pbotpd_claim(const char *path, const uint8_t pubkey[static 32],
+                 uint8_t challenge_out[static 32], uint8_t dh_shared_out[static 32]);
@@ -0,0 +1,62 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#include "utils.h"
+
+#include "pbotpd.h"
+
+int pbotpd_claim(const char *path, const uint8_t pubkey[static 32],
+                 uint8_t challenge_out[static 32], uint8_t dh_shared_out[static 32])
+{
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+	if (strlen(path) >= sizeof(addr.sun_path))
+		return -1;
+
+	strcpy(addr.sun_path, path);
+
+	int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		return -1;
+
+	int ret = -1;
+
+	// a stuck daemon must not hold up the login for long
+	struct timeval timeout = { .tv_sec = 1 };
+	if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0 ||
+	    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) < 0)
+		goto out;
+
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+		goto out;
+
+	// only a daemon running as root gets to choose our challenge
+	struct ucred cred;
+	socklen_t cred_len = sizeof(cred);
+	if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &cred_len) < 0 || cred.uid != 0)
+		goto out;
+
+	struct pbotpd_request req = { .version = PBOTPD_VERSION };
+	memcpy(req.pubkey, pubkey, sizeof(req.pubkey));
+
+	if (send(fd, &req, sizeof(req), MSG_NOSIGNAL) != sizeof(req))
+		goto out;
+
+	struct pbotpd_reply reply;
+	if (recv(fd, &reply, sizeof(reply), 0) == sizeof(reply) && reply.status == PBOTPD_OK) {
+		memcpy(challenge_out, reply.challenge, 32);
+		memcpy(dh_shared_out, reply.dh_shared, 32);
+		ret = 0;
+	}
+
+	wipe_sized(reply);
+
+out:
+	close(fd);
+
+	return ret;
+}
@@ -0,0 +1,363 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "tweetnacl.h"
+#include "utils.h"
+
+#include "pool.h"
+
+/* The pool file is a ring of precomputed challenges and their DH secrets for
+ * one public key. pbotp-pool fills free slots (in the order they will be
+ * claimed), logins advance the shared cursor and take over a ready slot with a
+ * compare and swap on its state, so any number of processes can claim without
+ * locking. Unlike the key cache the file holds secrets, so it is only accepted
+ * if nobody but root can access it. */
+
+#define POOL_MAGIC "pbotppl2"
+
+// pools older than this are neither claimed from nor refilled but replaced, so
+// that unused secrets (e.g. on a cloned system image) don't stay valid forever
+#define POOL_MAX_AGE (24 * 60 * 60)
+
+// a slot claimed for longer than this was left behind by a claimer that died,
+// live ones hold it for microseconds
+#define CLAIM_TIMEOUT 60
+
+enum slot_state {
+	SLOT_EMPTY,
+	SLOT_FILLING,
+	SLOT_READY,
+	SLOT_CLAIMED,
+};
+
+struct pool_header {
+	char magic[8];
+	uint32_t size;
+	_Atomic uint32_t cursor;
+	uint8_t pubkey[32];
+	int64_t created;  // CLOCK_REALTIME seconds
+	uint8_t pad[8];
+};
+
+struct pool_slot {
+	_Atomic uint32_t state;
+	_Atomic uint32_t claimed;  // CLOCK_BOOTTIME seconds + 1 while claimed, or 0
+	uint8_t pad[24];
+	uint8_t challenge[32];
+	uint8_t dh_shared[32];
+};
+
+_Static_assert(sizeof(struct pool_header) == 64, "unexpected header size");
+_Static_assert(sizeof(struct pool_slot) == 96, "unexpected slot size");
+_Static_assert(ATOMIC_INT_LOCK_FREE == 2, "the pool is shared between processes");
+
+static uint64_t pool_bytes(uint32_t size)
+{
+	return sizeof(struct pool_header) + (uint64_t)size * sizeof(struct pool_slot);
+}
+
+static struct pool_slot *pool_slots(struct pool_header *hdr)
+{
+	return (struct pool_slot *)(hdr + 1);
+}
+
+static int64_t now(clockid_t clock)
+{
+	struct timespec ts;
+	clock_gettime(clock, &ts);
+
+	return ts.tv_sec;
+}
+
+static bool pool_expired(const struct pool_header *hdr)
+{
+	int64_t age = now(CLOCK_REALTIME) - hdr->created;
+
+	return age < 0 || age > POOL_MAX_AGE;
+}
+
+static struct pool_header *map_pool(int fd, size_t *len_out)
+{
+	struct stat st;
+	if (fstat(fd, &st) < 0)
+		return NULL;
+
+	if (!S_ISREG(st.st_mode) || st.st_uid != 0 || (st.st_mode & (S_IRWXG | S_IRWXO))) {
+		errno = EPERM;
+		return NULL;
+	}
+
+	if ((size_t)st.st_size < sizeof(struct pool_header)) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	void *p = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (p == MAP_FAILED)
+		return NULL;
+
+	struct pool_header *hdr = p;
+	if (memcmp(hdr->magic, POOL_MAGIC, sizeof(hdr->magic)) != 0 ||
+	    hdr->size == 0 || pool_bytes(hdr->size) != (uint64_t)st.st_size) {
+		munmap(p, st.st_size);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	*len_out = st.st_size;
+
+	return hdr;
+}
+
+/* claims slot if it is ready, copying out and wiping its contents */
+static int claim_slot(struct pool_slot *slot, uint8_t challenge_out[static 32],
+                      uint8_t dh_shared_out[static 32])
+{
+	uint32_t expected = SLOT_READY;
+	if (!atomic_compare_exchange_strong(&slot->state, &expected, SLOT_CLAIMED))
+		return -1;
+
+	atomic_store(&slot->claimed, (uint32_t)now(CLOCK_BOOTTIME) + 1);
+
+	memcpy(challenge_out, slot->challenge, 32);
+	memcpy(dh_shared_out, slot->dh_shared, 32);
+	wipe_sized(slot->challenge);
+	wipe_sized(slot->dh_shared);
+
+	atomic_store(&slot->claimed, 0);
+	atomic_store(&slot->state, SLOT_EMPTY);
+
+	return 0;
+}
+
+int pool_claim(const char *path, const uint8_t pubkey[static 32],
+               uint8_t challenge_out[static 32], uint8_t dh_shared_out[static 32])
+{
+	int fd = open(path, O_RDWR | O_NOFOLLOW | O_CLOEXEC);
+	if (fd < 0)
+		return -1;
+
+	size_t len;
+	struct pool_header *hdr = map_pool(fd, &len);
+	close(fd);
+
+	if (!hdr)
+		return -1;
+
+	int ret = -1;
+
+	if (memcmp(hdr->pubkey, pubkey, 32) == 0 && !pool_expired(hdr)) {
+		struct pool_slot *slots = pool_slots(hdr);
+
+		// ready slots follow the cursor, give up after one round
+		for (uint32_t i = 0; i < hdr->size && ret < 0; i++) {
+			uint32_t idx = atomic_fetch_add(&hdr->cursor, 1) % hdr->size;
+			ret = claim_slot(&slots[idx], challenge_out, dh_shared_out);
+		}
+	}
+
+	munmap(hdr, len);
+
+	return ret;
+}
+
+/* creates an empty pool and returns its fd */
+static int create_pool(const char *path, const uint8_t pubkey[static 32], uint32_t size)
+{
+	if (geteuid() != 0) {
+		errno = EPERM;
+		return -1;
+	}
+
+	char tmp_path[PATH_MAX];
+	if (xsnprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", path) < 0) {
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	// mkstemp creates the file with mode 0600
+	int fd = mkstemp(tmp_path);
+	if (fd < 0)
+		return -1;
+
+	struct pool_header hdr = { .size = size, .created = now(CLOCK_REALTIME) };
+	memcpy(hdr.magic, POOL_MAGIC, sizeof(hdr.magic));
+	memcpy(hdr.pubkey, pubkey, 32);
+
+	// the slots are zero, i.e. SLOT_EMPTY
+	if (ftruncate(fd, pool_bytes(size)) < 0 ||
+	    pwrite(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr) ||
+	    rename(tmp_path, path) < 0) {
+		int saved_errno = errno;
+		close(fd);
+		unlink(tmp_path);
+		errno = saved_errno;
+		return -1;
+	}
+
+	return fd;
+}
+
+/* claims and wipes all ready slots of a pool that is about to be replaced */
+static void drain_pool(struct pool_header *hdr)
+{
+	struct pool_slot *slots = pool_slots(hdr);
+	uint8_t challenge[32], dh_shared[32];
+
+	for (uint32_t i = 0; i < hdr->size; i++)
+		claim_slot(&slots[i], challenge, dh_shared);
+
+	wipe_sized(challenge);
+	wipe_sized(dh_shared);
+}
+
+/* opens and maps the pool at path, replacing it if it doesn't match or has
+ * expired */
+static struct pool_header *open_pool(const char *path, const uint8_t pubkey[static 32],
+                                     uint32_t size, int *fd_out, size_t *len_out)
+{
+	int fd = open(path, O_RDWR | O_NOFOLLOW | O_CLOEXEC);
+	if (fd < 0 && errno != ENOENT)
+		return NULL;
+
+	struct pool_header *hdr = NULL;
+	if (fd >= 0) {
+		hdr = map_pool(fd, len_out);
+		if (hdr && (hdr->size != size || memcmp(hdr->pubkey, pubkey, 32) != 0 ||
+		            pool_expired(hdr))) {
+			// don't leave secrets behind in the replaced file
+			drain_pool(hdr);
+			munmap(hdr, *len_out);
+			hdr = NULL;
+		}
+
+		if (!hdr)
+			close(fd);
+	}
+
+	if (!hdr) {
+		fd = create_pool(path, pubkey, size);
+		if (fd < 0)
+			return NULL;
+
+		hdr = map_pool(fd, len_out);
+		if (!hdr) {
+			int saved_errno = errno;
+			close(fd);
+			errno = saved_errno;
+			return NULL;
+		}
+	}
+
+	*fd_out = fd;
+
+	return hdr;
+}
+
+/* Empties slot if it was claimed by a process that died before emptying it.
+ * A live claimer might still be copying from the slot, so it is only wiped
+ * once the claim is older than CLAIM_TIMEOUT. Claims without a time yet (the
+ * claimer died right after taking the slot) get one, and are recovered by a
+ * later fill. */
+static void recover_claimed(struct pool_slot *slot)
+{
+	if (atomic_load(&slot->state) != SLOT_CLAIMED)
+		return;
+
+	uint32_t boottime = now(CLOCK_BOOTTIME) + 1;
+	uint32_t claimed = 0;
+
+	if (atomic_compare_exchange_strong(&slot->claimed, &claimed, boottime) ||
+	    boottime - claimed <= CLAIM_TIMEOUT)
+		return;
+
+	wipe_sized(slot->challenge);
+	wipe_sized(slot->dh_shared);
+
+	atomic_store(&slot->claimed, 0);
+
+	uint32_t expected = SLOT_CLAIMED;
+	atomic_compare_exchange_strong(&slot->state, &expected, SLOT_EMPTY);
+}
+
+ssize_t pool_fill(const char *path, const uint8_t pubkey[static 32], size_t size,
+                  const void *table)
+{
+	if (size == 0 || size > UINT32_MAX) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	int fd;
+	size_t len;
+	struct pool_header *hdr = open_pool(path, pubkey, size, &fd, &len);
+	if (!hdr)
+		return -1;
+
+	ssize_t added = 0;
+	struct pool_slot *slots = pool_slots(hdr);
+
+	// only one filler at a time, which also means slots still being filled
+	// were left behind by a filler that died
+	if (flock(fd, LOCK_EX | LOCK_NB) < 0) {
+		added = errno == EWOULDBLOCK ? 0 : -1;
+		goto out;
+	}
+
+	for (uint32_t i = 0; i < size; i++) {
+		uint32_t expected = SLOT_FILLING;
+		atomic_compare_exchange_strong(&slots[i].state, &expected, SLOT_EMPTY);
+
+		recover_claimed(&slots[i]);
+	}
+
+	uint32_t start = atomic_load(&hdr->cursor);
+	for (uint32_t i = 0; i < size; i++) {
+		struct pool_slot *slot = &slots[(start + i) % size];
+
+		uint32_t expected = SLOT_EMPTY;
+		if (!atomic_compare_exchange_strong(&slot->state, &expected, SLOT_FILLING))
+			continue;
+
+		atomic_store(&slot->claimed, 0);
+
+		uint8_t secret[32];
+		if (randombytes(secret, sizeof(secret)) < 0) {
+			atomic_store(&slot->state, SLOT_EMPTY);
+			added = -1;
+			break;
+		}
+
+		int ret = crypto_scalarmult_base_pair(slot->challenge, slot->dh_shared, secret, pubkey, table);
+		wipe_sized(secret);
+
+		if (ret < 0) {
+			wipe_sized(slot->challenge);
+			wipe_sized(slot->dh_shared);
+			atomic_store(&slot->state, SLOT_EMPTY);
+			errno = EINVAL;
+			added = -1;
+			break;
+		}
+
+		atomic_store(&slot->state, SLOT_READY);
+		added++;
+	}
+
+out:
+	munmap(hdr, len);
+	close(fd);
+
+	return added;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+// claims a precomputed challenge for pubkey from the pool file at path and
+// wipes its slot, returns -1 if there is none (no or stale pool, empty, ...)
+int pool_claim(const char *path, const uint8_t pubkey[static 32],
+               uint8_t challenge_out[static 32], uint8_t dh_shared_out[static 32]);
+
+// fills the free slots of the pool file at path, which is (re)created with
+// size slots if it doesn't exist or doesn't match pubkey and size. table is
+// optional, see crypto_scalarmult_table. Returns the number of challenges
+// added or -1 on errors.
+ssize_t pool_fill(const char *path, const uint8_t pubkey[static 32], size_t size,
+                  const void *table);
@@ -4,8 +4,7 @@
 #include <stdbool.h>
 #include <string.h>
 
-#include <qrencode.h>
-
+#include "qrenc.h"
 #include "utils.h"
 
 #include "qr.h"
@@ -30,9 +29,10 @@ static char *memset_p(char *s, char c, size_t n)
 	return s;
 }
 
-static int write_qrcode_utf8(QRcode *qr, void (*print)(const char *line, void *arg), void *arg)
+static int write_qrcode_utf8(const struct qrcode *qr, struct arena *arena,
+                             void (*print)(const char *line, void *arg), void *arg)
 {
-	AUTOFREE_BUF(char, buf, strlen(ANSI_WHITE_ON_BLACK) + (qr->width + 2 * QUIET_SIZE) * 3 + strlen(ANSI_RESET) + 1);
+	char *buf = arena_alloc(arena, strlen(ANSI_WHITE_ON_BLACK) + (qr->width + 2 * QUIET_SIZE) * 3 + strlen(ANSI_RESET) + 1);
 	if (!buf)
 		return -1;
 
@@ -54,7 +54,7 @@ static int write_qrcode_utf8(QRcode *qr, void (*print)(const char *line, void *a
 		print(buf, arg);
 
 	for (size_t y = 0; y < (size_t)qr->width; y += 2) {
-		const uint8_t *row1 = qr->data + qr->width * y;
+		const uint8_t *row1 = qr->modules + qr->width * y;
 		const uint8_t *row2 = row1 + qr->width;
 
 		p = start;
@@ -92,9 +92,72 @@ static int write_qrcode_utf8(QRcode *qr, void (*print)(const char *line, void *a
 	return 0;
 }
 
-static int write_qrcode_ascii(QRcode *qr, void (*print)(const char *line, void *arg), void *arg)
+/* light module at x, y of the code including its quiet zone, which extends
+ * past QUIET_SIZE to fill partial braille cells */
+static bool light_at(const struct qrcode *qr, int x, int y)
+{
+	x -= QUIET_SIZE;
+	y -= QUIET_SIZE;
+
+	if (x < 0 || y < 0 || x >= qr->width || y >= qr->width)
+		return true;
+
+	return !(qr->modules[qr->width * y + x] & 1);
+}
+
+static int write_qrcode_braille(const struct qrcode *qr, struct arena *arena,
+                                void (*print)(const char *line, void *arg), void *arg)
 {
-	AUTOFREE_BUF(char, buf, 2 * (qr->width + 2 * QUIET_SIZE) + 1);
+	// dot numbers of the 2x4 braille cell: bit n is raised dot n + 1
+	static const uint8_t dots[4][2] = {
+		{ 0x01, 0x08 },
+		{ 0x02, 0x10 },
+		{ 0x04, 0x20 },
+		{ 0x40, 0x80 },
+	};
+
+	int size = qr->width + 2 * QUIET_SIZE;
+	int cols = (size + 1) / 2;
+
+	char *buf = arena_alloc(arena, strlen(ANSI_WHITE_ON_BLACK) + cols * 3 + strlen(ANSI_RESET) + 1);
+	if (!buf)
+		return -1;
+
+	char *start = stpcpy(buf, ANSI_WHITE_ON_BLACK);
+
+	// raised dots are drawn in the foreground color, so they mark the
+	// light modules
+	for (int y = 0; y < size; y += 4) {
+		char *p = start;
+
+		for (int x = 0; x < size; x += 2) {
+			uint8_t cell = 0;
+
+			for (int dy = 0; dy < 4; dy++) {
+				for (int dx = 0; dx < 2; dx++) {
+					if (light_at(qr, x + dx, y + dy))
+						cell |= dots[dy][dx];
+				}
+			}
+
+			// U+2800 + cell
+			*p++ = 0xe2;
+			*p++ = 0xa0 | (cell >> 6);
+			*p++ = 0x80 | (cell & 0x3f);
+		}
+
+		stpcpy(p, ANSI_RESET);
+
+		print(buf, arg);
+	}
+
+	return 0;
+}
+
+static int write_qrcode_ascii(const struct qrcode *qr, struct arena *arena,
+                              void (*print)(const char *line, void *arg), void *arg)
+{
+	char *buf = arena_alloc(arena, 2 * (qr->width + 2 * QUIET_SIZE) + 1);
 	if (!buf)
 		return -1;
 
@@ -104,7 +167,7 @@ static int write_qrcode_ascii(QRcode *qr, void (*print)(const char *line, void *
 	for (size_t i = 0; i < QUIET_SIZE; i++)
 		print(buf, arg);
 
-	unsigned char *qr_p = qr->data;
+	const uint8_t *qr_p = qr->modules;
 	for (size_t y = 0; y < (size_t) qr->width; y++) {
 		char *p = &buf[2 * QUIET_SIZE];
 
@@ -125,11 +188,12 @@ static int write_qrcode_ascii(QRcode *qr, void (*print)(const char *line, void *
 	return 0;
 }
 
-static int write_qrcode_ansi(QRcode *qr, void (*print)(const char *line, void *arg), void *arg)
+static int write_qrcode_ansi(const struct qrcode *qr, struct arena *arena,
+                             void (*print)(const char *line, void *arg), void *arg)
 {
 	/* worst case: one toggle every pixel -> one color sequence + two spaces
 	 * every pixel + final reset */
-	AUTOFREE_BUF(char, buf, (qr->width + 2 * QUIET_SIZE) * (strlen(ANSI_WHITE_BG) + 2) + strlen(ANSI_RESET) + 1);
+	char *buf = arena_alloc(arena, (qr->width + 2 * QUIET_SIZE) * (strlen(ANSI_WHITE_BG) + 2) + strlen(ANSI_RESET) + 1);
 	if (!buf)
 		return -1;
 
@@ -147,7 +211,7 @@ static int write_qrcode_ansi(QRcode *qr, void (*print)(const char *line, void *a
 	for (size_t i = 0; i < QUIET_SIZE; i++)
 		print(buf, arg);
 
-	unsigned char *qr_p = qr->data;
+	const uint8_t *qr_p = qr->modules;
 	for (size_t y = 0; y < (size_t) qr->width; y++) {
 		bool white = true;
 
@@ -183,28 +247,78 @@ static int write_qrcode_ansi(QRcode *qr, void (*print)(const char *line, void *a
 	return 0;
 }
 
-int print_qr(const char *str, enum qr_mode mode, void (*print)(const char *line, void *arg), void *arg)
+struct qrcode *encode_qr(const char *str, struct arena *arena)
 {
-	QRcode *qr;
-	qr = QRcode_encodeString(str, 0, QR_ECLEVEL_L, QR_MODE_8, 1);
-	if (!qr) {
-		perror("generating QR code failed");
-		return -1;
+	struct qrcode *qr = arena_alloc(arena, sizeof(*qr));
+	if (!qr)
+		return NULL;
+
+	if (qrenc_encode(qr, str) < 0) {
+		fprintf(stderr, "URL too long for a QR code\n");
+		return NULL;
 	}
 
-	int ret = -1;
+	return qr;
+}
+
+int print_qr(const struct qrcode *qr, enum qr_mode mode, struct arena *arena,
+             void (*print)(const char *line, void *arg), void *arg)
+{
 	switch (mode) {
 		case QR_MODE_UTF8:
-			ret = write_qrcode_utf8(qr, print, arg);
-			break;
+			return write_qrcode_utf8(qr, arena, print, arg);
 		case QR_MODE_ANSI:
-			ret = write_qrcode_ansi(qr, print, arg);
-			break;
+			return write_qrcode_ansi(qr, arena, print, arg);
 		case QR_MODE_ASCII:
-			ret = write_qrcode_ascii(qr, print, arg);
-			break;
+			return write_qrcode_ascii(qr, arena, print, arg);
+		case QR_MODE_BRAILLE:
+			return write_qrcode_braille(qr, arena, print, arg);
+	}
+
+	return -1;
+}
+
+struct text {
+	char *buf; // NULL while measuring
+	size_t len;
+};
+
+static void append_line(const char *line, void *arg)
+{
+	struct text *text = arg;
+	size_t len = strlen(line);
+
+	if (text->buf) {
+		memcpy(text->buf + text->len, line, len);
+		text->buf[text->len + len] = '\n';
 	}
 
-	QRcode_free(qr);
-	return ret;
+	text->len += len + 1;
+}
+
+char *format_qr(const struct qrcode *qr, enum qr_mode mode, const char *header,
+                const char *footer, struct arena *arena)
+{
+	// the ANSI lines depend on the modules, so the QR code is rendered
+	// twice: once to measure, once into the buffer
+	struct text text = { 0 };
+
+	append_line(header, &text);
+	if (print_qr(qr, mode, arena, append_line, &text) < 0)
+		return NULL;
+
+	size_t size = text.len + strlen(footer) + 1;
+
+	text.buf = arena_alloc(arena, size);
+	if (!text.buf)
+		return NULL;
+
+	text.len = 0;
+	append_line(header, &text);
+	if (print_qr(qr, mode, arena, append_line, &text) < 0)
+		return NULL;
+
+	strcpy(text.buf + text.len, footer);
+
+	return text.buf;
 }
@@ -4,6 +4,20 @@ enum qr_mode {
 	QR_MODE_UTF8,
 	QR_MODE_ANSI,
 	QR_MODE_ASCII,
+	QR_MODE_BRAILLE,
 };
 
-int print_qr(const char *str, enum qr_mode mode, void (*print)(const char *line, void *arg), void *arg);
+struct arena;
+struct qrcode;
+
+// encodes str into a QR code taken from arena, NULL if it doesn't fit
+struct qrcode *encode_qr(const char *str, struct arena *arena);
+
+// calls print for every line, the line buffer is taken from arena
+int print_qr(const struct qrcode *qr, enum qr_mode mode, struct arena *arena,
+             void (*print)(const char *line, void *arg), void *arg);
+
+// renders header, the QR code and footer into one string of newline separated
+// lines, allocated from arena with its exact size. NULL if arena is too small.
+char *format_qr(const struct qrcode *qr, enum qr_mode mode, const char *header,
+                const char *footer, struct arena *arena);
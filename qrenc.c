@@ -0,0 +1,738 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+
+#include "qrenc.h"
+
+/* Only error correction level L is supported, and only the versions listed in
+ * the table below. The Reed-Solomon code works in GF(256) reduced by
+ * x^8 + x^4 + x^3 + x^2 + 1. The generator polynomials are
+ * (x - a^0) ... (x - a^(n-1)), stored as the logarithms of their coefficients
+ * without the leading 1. Format and version information are the BCH coded
+ * values from ISO/IEC 18004, the format information already masked with
+ * 0x5412. */
+
+#define DATA_MAX 428       // data codewords of the largest version
+#define CODEWORDS_MAX 532  // data and EC codewords of the largest version
+#define BLOCKS_MAX 4
+#define EC_MAX 30
+#define CHARS_MAX (8 * DATA_MAX * 3 / 10)  // digits in the largest version
+#define SEGMENTS_MAX (8 * DATA_MAX / 12)   // segment headers take at least 12 bits
+
+#define DARK 1
+#define FUNCTION 2
+
+static const uint8_t gf_exp[255] = {
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1d, 0x3a, 0x74, 0xe8, 0xcd, 0x87, 0x13, 0x26,
+	0x4c, 0x98, 0x2d, 0x5a, 0xb4, 0x75, 0xea, 0xc9, 0x8f, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0,
+	0x9d, 0x27, 0x4e, 0x9c, 0x25, 0x4a, 0x94, 0x35, 0x6a, 0xd4, 0xb5, 0x77, 0xee, 0xc1, 0x9f, 0x23,
+	0x46, 0x8c, 0x05, 0x0a, 0x14, 0x28, 0x50, 0xa0, 0x5d, 0xba, 0x69, 0xd2, 0xb9, 0x6f, 0xde, 0xa1,
+	0x5f, 0xbe, 0x61, 0xc2, 0x99, 0x2f, 0x5e, 0xbc, 0x65, 0xca, 0x89, 0x0f, 0x1e, 0x3c, 0x78, 0xf0,
+	0xfd, 0xe7, 0xd3, 0xbb, 0x6b, 0xd6, 0xb1, 0x7f, 0xfe, 0xe1, 0xdf, 0xa3, 0x5b, 0xb6, 0x71, 0xe2,
+	0xd9, 0xaf, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0d, 0x1a, 0x34, 0x68, 0xd0, 0xbd, 0x67, 0xce,
+	0x81, 0x1f, 0x3e, 0x7c, 0xf8, 0xed, 0xc7, 0x93, 0x3b, 0x76, 0xec, 0xc5, 0x97, 0x33, 0x66, 0xcc,
+	0x85, 0x17, 0x2e, 0x5c, 0xb8, 0x6d, 0xda, 0xa9, 0x4f, 0x9e, 0x21, 0x42, 0x84, 0x15, 0x2a, 0x54,
+	0xa8, 0x4d, 0x9a, 0x29, 0x52, 0xa4, 0x55, 0xaa, 0x49, 0x92, 0x39, 0x72, 0xe4, 0xd5, 0xb7, 0x73,
+	0xe6, 0xd1, 0xbf, 0x63, 0xc6, 0x91, 0x3f, 0x7e, 0xfc, 0xe5, 0xd7, 0xb3, 0x7b, 0xf6, 0xf1, 0xff,
+	0xe3, 0xdb, 0xab, 0x4b, 0x96, 0x31, 0x62, 0xc4, 0x95, 0x37, 0x6e, 0xdc, 0xa5, 0x57, 0xae, 0x41,
+	0x82, 0x19, 0x32, 0x64, 0xc8, 0x8d, 0x07, 0x0e, 0x1c, 0x38, 0x70, 0xe0, 0xdd, 0xa7, 0x53, 0xa6,
+	0x51, 0xa2, 0x59, 0xb2, 0x79, 0xf2, 0xf9, 0xef, 0xc3, 0x9b, 0x2b, 0x56, 0xac, 0x45, 0x8a, 0x09,
+	0x12, 0x24, 0x48, 0x90, 0x3d, 0x7a, 0xf4, 0xf5, 0xf7, 0xf3, 0xfb, 0xeb, 0xcb, 0x8b, 0x0b, 0x16,
+	0x2c, 0x58, 0xb0, 0x7d, 0xfa, 0xe9, 0xcf, 0x83, 0x1b, 0x36, 0x6c, 0xd8, 0xad, 0x47, 0x8e,
+};
+
+static const uint8_t gf_log[256] = {
+	0x00, 0x00, 0x01, 0x19, 0x02, 0x32, 0x1a, 0xc6, 0x03, 0xdf, 0x33, 0xee, 0x1b, 0x68, 0xc7, 0x4b,
+	0x04, 0x64, 0xe0, 0x0e, 0x34, 0x8d, 0xef, 0x81, 0x1c, 0xc1, 0x69, 0xf8, 0xc8, 0x08, 0x4c, 0x71,
+	0x05, 0x8a, 0x65, 0x2f, 0xe1, 0x24, 0x0f, 0x21, 0x35, 0x93, 0x8e, 0xda, 0xf0, 0x12, 0x82, 0x45,
+	0x1d, 0xb5, 0xc2, 0x7d, 0x6a, 0x27, 0xf9, 0xb9, 0xc9, 0x9a, 0x09, 0x78, 0x4d, 0xe4, 0x72, 0xa6,
+	0x06, 0xbf, 0x8b, 0x62, 0x66, 0xdd, 0x30, 0xfd, 0xe2, 0x98, 0x25, 0xb3, 0x10, 0x91, 0x22, 0x88,
+	0x36, 0xd0, 0x94, 0xce, 0x8f, 0x96, 0xdb, 0xbd, 0xf1, 0xd2, 0x13, 0x5c, 0x83, 0x38, 0x46, 0x40,
+	0x1e, 0x42, 0xb6, 0xa3, 0xc3, 0x48, 0x7e, 0x6e, 0x6b, 0x3a, 0x28, 0x54, 0xfa, 0x85, 0xba, 0x3d,
+	0xca, 0x5e, 0x9b, 0x9f, 0x0a, 0x15, 0x79, 0x2b, 0x4e, 0xd4, 0xe5, 0xac, 0x73, 0xf3, 0xa7, 0x57,
+	0x07, 0x70, 0xc0, 0xf7, 0x8c, 0x80, 0x63, 0x0d, 0x67, 0x4a, 0xde, 0xed, 0x31, 0xc5, 0xfe, 0x18,
+	0xe3, 0xa5, 0x99, 0x77, 0x26, 0xb8, 0xb4, 0x7c, 0x11, 0x44, 0x92, 0xd9, 0x23, 0x20, 0x89, 0x2e,
+	0x37, 0x3f, 0xd1, 0x5b, 0x95, 0xbc, 0xcf, 0xcd, 0x90, 0x87, 0x97, 0xb2, 0xdc, 0xfc, 0xbe, 0x61,
+	0xf2, 0x56, 0xd3, 0xab, 0x14, 0x2a, 0x5d, 0x9e, 0x84, 0x3c, 0x39, 0x53, 0x47, 0x6d, 0x41, 0xa2,
+	0x1f, 0x2d, 0x43, 0xd8, 0xb7, 0x7b, 0xa4, 0x76, 0xc4, 0x17, 0x49, 0xec, 0x7f, 0x0c, 0x6f, 0xf6,
+	0x6c, 0xa1, 0x3b, 0x52, 0x29, 0x9d, 0x55, 0xaa, 0xfb, 0x60, 0x86, 0xb1, 0xbb, 0xcc, 0x3e, 0x5a,
+	0xcb, 0x59, 0x5f, 0xb0, 0x9c, 0xa9, 0xa0, 0x51, 0x0b, 0xf5, 0x16, 0xeb, 0x7a, 0x75, 0x2c, 0xd7,
+	0x4f, 0xae, 0xd5, 0xe9, 0xe6, 0xe7, 0xad, 0xe8, 0x74, 0xd6, 0xf4, 0xea, 0xa8, 0x50, 0x58, 0xaf,
+};
+
+enum { GEN_7, GEN_10, GEN_15, GEN_18, GEN_20, GEN_24, GEN_26, GEN_30 };
+
+static const uint8_t gen_poly[][EC_MAX] = {
+	[GEN_7] = { 87, 229, 146, 149, 238, 102, 21 },
+	[GEN_10] = { 251, 67, 46, 61, 118, 70, 64, 94, 32, 45 },
+	[GEN_15] = { 8, 183, 61, 91, 202, 37, 51, 58, 58, 237, 140, 124, 5, 99, 105 },
+	[GEN_18] = { 215, 234, 158, 94, 184, 97, 118, 170, 79, 187, 152, 148, 252, 179, 5, 98, 96, 153 },
+	[GEN_20] = { 17, 60, 79, 50, 61, 163, 26, 187, 202, 180, 221, 225, 83, 239, 156, 164, 212, 212, 188, 190 },
+	[GEN_24] = { 229, 121, 135, 48, 211, 117, 251, 126, 159, 180, 169, 152, 192, 226, 228, 218, 111, 0, 117, 232, 87, 96, 227, 21 },
+	[GEN_26] = { 173, 125, 158, 2, 103, 182, 118, 17, 145, 201, 111, 28, 165, 53, 161, 21, 245, 142, 13, 102, 48, 227, 153, 145, 218, 70 },
+	[GEN_30] = { 41, 173, 145, 152, 216, 31, 179, 182, 50, 48, 110, 86, 239, 96, 222, 125, 42, 173, 226, 193, 224, 130, 156, 37, 251, 216, 238, 40, 192, 180 },
+};
+
+static const struct version_info {
+	uint8_t ec_len;    // EC codewords per block
+	uint8_t gen;       // generator polynomial for ec_len
+	uint8_t blocks1;   // blocks with data_len data codewords
+	uint8_t blocks2;   // blocks with data_len + 1 data codewords
+	uint8_t data_len;
+	uint8_t align[2];  // alignment pattern coordinates besides 6, 0 if unused
+} versions[QRENC_VERSION_MAX + 1] = {
+	[1]  = {  7, GEN_7,  1, 0,  19, {  0,  0 } },
+	[2]  = { 10, GEN_10, 1, 0,  34, { 18,  0 } },
+	[3]  = { 15, GEN_15, 1, 0,  55, { 22,  0 } },
+	[4]  = { 20, GEN_20, 1, 0,  80, { 26,  0 } },
+	[5]  = { 26, GEN_26, 1, 0, 108, { 30,  0 } },
+	[6]  = { 18, GEN_18, 2, 0,  68, { 34,  0 } },
+	[7]  = { 20, GEN_20, 2, 0,  78, { 22, 38 } },
+	[8]  = { 24, GEN_24, 2, 0,  97, { 24, 42 } },
+	[9]  = { 30, GEN_30, 2, 0, 116, { 26, 46 } },
+	[10] = { 18, GEN_18, 2, 2,  68, { 28, 50 } },
+	[11] = { 20, GEN_20, 4, 0,  81, { 30, 54 } },
+	[12] = { 24, GEN_24, 2, 2,  92, { 32, 58 } },
+	[13] = { 26, GEN_26, 4, 0, 107, { 34, 62 } },
+};
+
+static const uint16_t format_bits[8] = {
+	0x77c4, 0x72f3, 0x7daa, 0x789d, 0x662f, 0x6318, 0x6c41, 0x6976,
+};
+
+static const uint32_t version_bits[QRENC_VERSION_MAX + 1] = {
+	[7] = 0x07c94, 0x085bc, 0x09a99, 0x0a4d3, 0x0bbf6, 0x0c762, 0x0d847,
+};
+
+static size_t data_codewords(const struct version_info *v)
+{
+	return v->blocks1 * v->data_len + v->blocks2 * (v->data_len + 1);
+}
+
+static int alnum_value(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+
+	if (c >= 'A' && c <= 'Z')
+		return c - 'A' + 10;
+
+	switch (c) {
+		case ' ': return 36;
+		case '$': return 37;
+		case '%': return 38;
+		case '*': return 39;
+		case '+': return 40;
+		case '-': return 41;
+		case '.': return 42;
+		case '/': return 43;
+		case ':': return 44;
+	}
+
+	return -1;
+}
+
+bool qrenc_is_alnum(char c)
+{
+	return alnum_value(c) >= 0;
+}
+
+static bool mode_allows(enum qrenc_mode mode, char c)
+{
+	switch (mode) {
+		case QRENC_MODE_NUMERIC:
+			return c >= '0' && c <= '9';
+		case QRENC_MODE_ALNUM:
+			return qrenc_is_alnum(c);
+		case QRENC_MODE_BYTE:
+			break;
+	}
+
+	return true;
+}
+
+static int count_bits(enum qrenc_mode mode, int version)
+{
+	// versions 10 to 26 have longer character counts
+	switch (mode) {
+		case QRENC_MODE_NUMERIC:
+			return version < 10 ? 10 : 12;
+		case QRENC_MODE_ALNUM:
+			return version < 10 ? 9 : 11;
+		case QRENC_MODE_BYTE:
+			break;
+	}
+
+	return version < 10 ? 8 : 16;
+}
+
+/* bits needed for seg in version, SIZE_MAX if its length can't be encoded */
+static size_t segment_bits(const struct qrenc_segment *seg, int version)
+{
+	int len_bits = count_bits(seg->mode, version);
+	if (seg->len >> len_bits)
+		return SIZE_MAX;
+
+	// trailing single digits take 4 bits, pairs 7
+	if (seg->mode == QRENC_MODE_NUMERIC)
+		return 4 + len_bits + 10 * (seg->len / 3) + (seg->len % 3 ? 3 * (seg->len % 3) + 1 : 0);
+
+	if (seg->mode == QRENC_MODE_ALNUM)
+		return 4 + len_bits + 11 * (seg->len / 2) + 6 * (seg->len % 2);
+
+	return 4 + len_bits + 8 * seg->len;
+}
+
+static size_t segments_bits(const struct qrenc_segment *segs, size_t count, int version)
+{
+	size_t bits = 0;
+
+	for (size_t i = 0; i < count && bits != SIZE_MAX; i++) {
+		size_t seg_bits = segment_bits(&segs[i], version);
+		bits = seg_bits == SIZE_MAX ? SIZE_MAX : bits + seg_bits;
+	}
+
+	return bits;
+}
+
+/* Splits str into the numeric, alphanumeric and byte segments taking the
+ * fewest bits with the character count lengths of version, SIZE_MAX if that
+ * needs more than SEGMENTS_MAX segments.
+ *
+ * The shortest encoding is found by dynamic programming over the characters,
+ * with the state after each character being the mode it is encoded in. Since
+ * numeric and alphanumeric segments pack groups of characters (3 digits in 10
+ * bits, 2 characters in 11) and shorter ones at their end, their states also
+ * track the position in the group, which makes the costs exact: 4, 3 and 3
+ * bits for the digits of a group, 6 and 5 for the alphanumeric pair. */
+
+enum { BYTE, NUMERIC_1, NUMERIC_2, NUMERIC_3, ALNUM_1, ALNUM_2, SPLIT_STATES };
+
+static const struct split_state {
+	uint8_t mode;
+	uint8_t prev;  // state continuing the segment
+	uint8_t bits;  // bits taken by the character
+	bool start;    // the character can start a segment
+} split_states[SPLIT_STATES] = {
+	[BYTE] = { QRENC_MODE_BYTE, BYTE, 8, true },
+	[NUMERIC_1] = { QRENC_MODE_NUMERIC, NUMERIC_3, 4, true },
+	[NUMERIC_2] = { QRENC_MODE_NUMERIC, NUMERIC_1, 3, false },
+	[NUMERIC_3] = { QRENC_MODE_NUMERIC, NUMERIC_2, 3, false },
+	[ALNUM_1] = { QRENC_MODE_ALNUM, ALNUM_2, 6, true },
+	[ALNUM_2] = { QRENC_MODE_ALNUM, ALNUM_1, 5, false },
+};
+
+static size_t split_segments(const char *str, size_t len, int version, struct qrenc_segment *segs)
+{
+	if (len == 0)
+		return 0;
+
+	// far from overflowing when a few characters are added
+	const size_t unreachable = SIZE_MAX / 2;
+
+	// state each character's state was reached from
+	uint8_t from[CHARS_MAX][SPLIT_STATES];
+	size_t bits[SPLIT_STATES];
+
+	for (size_t i = 0; i < len; i++) {
+		size_t next[SPLIT_STATES];
+
+		for (uint8_t s = 0; s < SPLIT_STATES; s++) {
+			const struct split_state *state = &split_states[s];
+
+			next[s] = unreachable;
+			from[i][s] = s;
+
+			if (!mode_allows(state->mode, str[i]))
+				continue;
+
+			size_t header = 4 + count_bits(state->mode, version);
+
+			if (i == 0) {
+				if (state->start)
+					next[s] = header + state->bits;
+				continue;
+			}
+
+			// continue the running segment or start one after a
+			// segment of another mode
+			if (bits[state->prev] + state->bits < next[s]) {
+				next[s] = bits[state->prev] + state->bits;
+				from[i][s] = state->prev;
+			}
+
+			for (uint8_t t = 0; t < SPLIT_STATES && state->start; t++) {
+				if (split_states[t].mode != state->mode && bits[t] + header + state->bits < next[s]) {
+					next[s] = bits[t] + header + state->bits;
+					from[i][s] = t;
+				}
+			}
+		}
+
+		memcpy(bits, next, sizeof(bits));
+	}
+
+	// walk back from the cheapest final state, leaving each character's
+	// mode in from[i][0]
+	uint8_t state = BYTE;
+	for (uint8_t s = 0; s < SPLIT_STATES; s++) {
+		if (bits[s] < bits[state])
+			state = s;
+	}
+
+	for (size_t i = len; i-- > 0;) {
+		uint8_t prev = from[i][state];
+		from[i][0] = split_states[state].mode;
+		state = prev;
+	}
+
+	size_t count = 0;
+
+	for (size_t i = 0; i < len; i++) {
+		if (i == 0 || from[i][0] != from[i - 1][0]) {
+			if (count == SEGMENTS_MAX)
+				return SIZE_MAX;
+
+			segs[count++] = (struct qrenc_segment) {
+				.mode = from[i][0],
+				.data = str + i,
+			};
+		}
+
+		segs[count - 1].len++;
+	}
+
+	return count;
+}
+
+struct bitbuf {
+	uint8_t *data;
+	size_t bits;
+};
+
+static void put_bits(struct bitbuf *b, uint32_t value, int n)
+{
+	for (int i = n - 1; i >= 0; i--) {
+		if ((value >> i) & 1)
+			b->data[b->bits / 8] |= 0x80 >> (b->bits % 8);
+
+		b->bits++;
+	}
+}
+
+static void put_segment(struct bitbuf *b, const struct qrenc_segment *seg, int version)
+{
+	const uint8_t *p = (const uint8_t *)seg->data;
+
+	if (seg->mode == QRENC_MODE_NUMERIC) {
+		put_bits(b, 0x1, 4);
+		put_bits(b, seg->len, count_bits(seg->mode, version));
+
+		// groups of 3 digits, a shorter one at the end
+		for (size_t i = 0; i < seg->len; i += 3) {
+			size_t n = seg->len - i < 3 ? seg->len - i : 3;
+			uint32_t value = 0;
+
+			for (size_t j = 0; j < n; j++)
+				value = value * 10 + (p[i + j] - '0');
+
+			put_bits(b, value, 3 * n + 1);
+		}
+	} else if (seg->mode == QRENC_MODE_ALNUM) {
+		put_bits(b, 0x2, 4);
+		put_bits(b, seg->len, count_bits(seg->mode, version));
+
+		size_t i;
+		for (i = 0; i + 1 < seg->len; i += 2)
+			put_bits(b, alnum_value(p[i]) * 45 + alnum_value(p[i + 1]), 11);
+
+		if (i < seg->len)
+			put_bits(b, alnum_value(p[i]), 6);
+	} else {
+		put_bits(b, 0x4, 4);
+		put_bits(b, seg->len, count_bits(seg->mode, version));
+
+		for (size_t i = 0; i < seg->len; i++)
+			put_bits(b, p[i], 8);
+	}
+}
+
+static void rs_encode(const uint8_t *data, size_t len, const uint8_t *gen, size_t ec_len,
+                      uint8_t *ec)
+{
+	memset(ec, 0, ec_len);
+
+	for (size_t i = 0; i < len; i++) {
+		uint8_t factor = data[i] ^ ec[0];
+
+		memmove(ec, ec + 1, ec_len - 1);
+		ec[ec_len - 1] = 0;
+
+		if (factor) {
+			unsigned int log_factor = gf_log[factor];
+
+			for (size_t j = 0; j < ec_len; j++)
+				ec[j] ^= gf_exp[(log_factor + gen[j]) % 255];
+		}
+	}
+}
+
+/* splits data into blocks, adds their EC codewords and interleaves them */
+static size_t interleave(const struct version_info *v, const uint8_t *data, uint8_t *out)
+{
+	size_t blocks = v->blocks1 + v->blocks2;
+	uint8_t ec[BLOCKS_MAX][EC_MAX];
+	const uint8_t *block_data[BLOCKS_MAX];
+	size_t block_len[BLOCKS_MAX];
+
+	for (size_t b = 0; b < blocks; b++) {
+		block_len[b] = v->data_len + (b >= v->blocks1);
+		block_data[b] = data;
+		rs_encode(data, block_len[b], gen_poly[v->gen], v->ec_len, ec[b]);
+
+		data += block_len[b];
+	}
+
+	size_t n = 0;
+	for (size_t i = 0; i <= v->data_len; i++) {
+		for (size_t b = 0; b < blocks; b++) {
+			if (i < block_len[b])
+				out[n++] = block_data[b][i];
+		}
+	}
+
+	for (size_t i = 0; i < v->ec_len; i++) {
+		for (size_t b = 0; b < blocks; b++)
+			out[n++] = ec[b][i];
+	}
+
+	return n;
+}
+
+static void set_function(struct qrcode *qr, int x, int y, bool dark)
+{
+	qr->modules[y * qr->width + x] = FUNCTION | dark;
+}
+
+/* finder pattern centered at cx/cy including its separator */
+static void draw_finder(struct qrcode *qr, int cx, int cy)
+{
+	for (int dy = -4; dy <= 4; dy++) {
+		for (int dx = -4; dx <= 4; dx++) {
+			int x = cx + dx, y = cy + dy;
+			int dist = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+
+			if (x >= 0 && x < qr->width && y >= 0 && y < qr->width)
+				set_function(qr, x, y, dist != 2 && dist != 4);
+		}
+	}
+}
+
+static void draw_alignment(struct qrcode *qr, int cx, int cy)
+{
+	for (int dy = -2; dy <= 2; dy++) {
+		for (int dx = -2; dx <= 2; dx++) {
+			int dist = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+
+			set_function(qr, cx + dx, cy + dy, dist != 1);
+		}
+	}
+}
+
+static void draw_format(struct qrcode *qr, uint16_t bits)
+{
+	int w = qr->width;
+
+	// around the top left finder
+	for (int i = 0; i <= 5; i++)
+		set_function(qr, 8, i, (bits >> i) & 1);
+
+	set_function(qr, 8, 7, (bits >> 6) & 1);
+	set_function(qr, 8, 8, (bits >> 7) & 1);
+	set_function(qr, 7, 8, (bits >> 8) & 1);
+
+	for (int i = 9; i < 15; i++)
+		set_function(qr, 14 - i, 8, (bits >> i) & 1);
+
+	// the copy next to the other finders
+	for (int i = 0; i < 8; i++)
+		set_function(qr, w - 1 - i, 8, (bits >> i) & 1);
+
+	for (int i = 8; i < 15; i++)
+		set_function(qr, 8, w - 15 + i, (bits >> i) & 1);
+
+	set_function(qr, 8, w - 8, true);
+}
+
+static void draw_function_patterns(struct qrcode *qr, const struct version_info *v)
+{
+	int w = qr->width;
+
+	// timing patterns, the finders overwrite their ends
+	for (int i = 0; i < w; i++) {
+		set_function(qr, 6, i, i % 2 == 0);
+		set_function(qr, i, 6, i % 2 == 0);
+	}
+
+	draw_finder(qr, 3, 3);
+	draw_finder(qr, w - 4, 3);
+	draw_finder(qr, 3, w - 4);
+
+	if (qr->version >= 2) {
+		int pos[3] = { 6, v->align[0], v->align[1] };
+		int n = v->align[1] ? 3 : 2;
+
+		for (int i = 0; i < n; i++) {
+			for (int j = 0; j < n; j++) {
+				// except where the finders are
+				if ((i == 0 && j == 0) || (i == 0 && j == n - 1) || (i == n - 1 && j == 0))
+					continue;
+
+				draw_alignment(qr, pos[i], pos[j]);
+			}
+		}
+	}
+
+	// reserves the area, the bits are drawn for each mask
+	draw_format(qr, 0);
+
+	if (qr->version >= 7) {
+		for (int i = 0; i < 18; i++) {
+			bool bit = (version_bits[qr->version] >> i) & 1;
+			int a = w - 11 + i % 3, b = i / 3;
+
+			set_function(qr, a, b, bit);
+			set_function(qr, b, a, bit);
+		}
+	}
+}
+
+/* places the codewords in the two module wide columns zig-zagging up and down
+ * from the right, skipping the vertical timing pattern */
+static void place_codewords(struct qrcode *qr, const uint8_t *codewords, size_t n)
+{
+	int w = qr->width;
+	size_t i = 0;
+
+	for (int right = w - 1; right >= 1; right -= 2) {
+		if (right == 6)
+			right = 5;
+
+		bool upward = ((right + 1) & 2) == 0;
+
+		for (int vert = 0; vert < w; vert++) {
+			int y = upward ? w - 1 - vert : vert;
+
+			for (int x = right; x >= right - 1; x--) {
+				uint8_t *m = &qr->modules[y * w + x];
+
+				// remainder bits stay light
+				if (!(*m & FUNCTION) && i < n * 8) {
+					*m = (codewords[i / 8] >> (7 - i % 8)) & 1;
+					i++;
+				}
+			}
+		}
+	}
+}
+
+static bool mask_bit(int mask, int x, int y)
+{
+	switch (mask) {
+		case 0: return (x + y) % 2 == 0;
+		case 1: return y % 2 == 0;
+		case 2: return x % 3 == 0;
+		case 3: return (x + y) % 3 == 0;
+		case 4: return (x / 3 + y / 2) % 2 == 0;
+		case 5: return x * y % 2 + x * y % 3 == 0;
+		case 6: return (x * y % 2 + x * y % 3) % 2 == 0;
+		case 7: return ((x + y) % 2 + x * y % 3) % 2 == 0;
+	}
+
+	return false;
+}
+
+/* toggles the data modules selected by mask, applying it twice undoes it */
+static void apply_mask(struct qrcode *qr, int mask)
+{
+	int w = qr->width;
+
+	for (int y = 0; y < w; y++) {
+		uint8_t *row = &qr->modules[y * w];
+
+		for (int x = 0; x < w; x++) {
+			if (!(row[x] & FUNCTION))
+				row[x] ^= mask_bit(mask, x, y);
+		}
+	}
+}
+
+/* penalties for runs of five or more modules (N1) and finder-like patterns
+ * (N3, only those that fit in the symbol) in a row or column in one pass,
+ * keeping the last 11 modules in a bit window */
+static unsigned int line_penalty(const uint8_t *m, size_t stride, int w)
+{
+	unsigned int penalty = 0, run = 0, window = 0;
+	int prev = -1;
+
+	for (int i = 0; i < w; i++) {
+		int dark = m[i * stride] & DARK;
+
+		if (dark == prev) {
+			run++;
+		} else {
+			if (run >= 5)
+				penalty += run - 2;
+
+			run = 1;
+			prev = dark;
+		}
+
+		window = ((window << 1) | dark) & 0x7ff;
+		if (i >= 10 && (window == 0x5d0 || window == 0x05d))
+			penalty += 40;
+	}
+
+	if (run >= 5)
+		penalty += run - 2;
+
+	return penalty;
+}
+
+static unsigned int penalty(const struct qrcode *qr)
+{
+	int w = qr->width;
+	const uint8_t *m = qr->modules;
+	unsigned int penalty = 0, dark = 0;
+
+	for (int i = 0; i < w; i++) {
+		penalty += line_penalty(m + i * w, 1, w);
+		penalty += line_penalty(m + i, w, w);
+	}
+
+	// 2x2 blocks of one color (N2) and the dark module count (N4)
+	for (int y = 0; y < w; y++) {
+		const uint8_t *row = m + y * w;
+
+		for (int x = 0; x < w; x++) {
+			dark += row[x] & DARK;
+
+			if (x + 1 < w && y + 1 < w) {
+				int c = row[x] & DARK;
+
+				if (c == (row[x + 1] & DARK) && c == (row[x + w] & DARK) &&
+				    c == (row[x + w + 1] & DARK))
+					penalty += 3;
+			}
+		}
+	}
+
+	unsigned int total = w * w;
+	unsigned int deviation = 20 * dark > 10 * total ? 20 * dark - 10 * total : 10 * total - 20 * dark;
+	penalty += 10 * (deviation / total);
+
+	return penalty;
+}
+
+int qrenc_encode_segments(struct qrcode *qr, const struct qrenc_segment *segs, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		for (size_t j = 0; j < segs[i].len; j++) {
+			if (!mode_allows(segs[i].mode, segs[i].data[j]))
+				return -1;
+		}
+	}
+
+	int version;
+	size_t capacity = 0;
+
+	for (version = 1; version <= QRENC_VERSION_MAX; version++) {
+		capacity = 8 * data_codewords(&versions[version]);
+		if (segments_bits(segs, count, version) <= capacity)
+			break;
+	}
+
+	if (version > QRENC_VERSION_MAX)
+		return -1;
+
+	const struct version_info *v = &versions[version];
+
+	uint8_t data[DATA_MAX] = { 0 };
+	struct bitbuf b = { .data = data };
+
+	for (size_t i = 0; i < count; i++)
+		put_segment(&b, &segs[i], version);
+
+	// terminator (as far as it fits), then pad bytes
+	b.bits += capacity - b.bits < 4 ? capacity - b.bits : 4;
+	b.bits = (b.bits + 7) & ~(size_t)7;
+
+	uint8_t pad = 0xec;
+	for (size_t i = b.bits / 8; i < capacity / 8; i++) {
+		data[i] = pad;
+		pad ^= 0xec ^ 0x11;
+	}
+
+	uint8_t codewords[CODEWORDS_MAX];
+	size_t n = interleave(v, data, codewords);
+
+	qr->version = version;
+	qr->width = 17 + 4 * version;
+	memset(qr->modules, 0, qr->width * qr->width);
+
+	draw_function_patterns(qr, v);
+	place_codewords(qr, codewords, n);
+
+	// the mask with the lowest penalty, including its format information
+	int best_mask = 0;
+	unsigned int best_penalty = UINT_MAX;
+
+	for (int mask = 0; mask < 8; mask++) {
+		apply_mask(qr, mask);
+		draw_format(qr, format_bits[mask]);
+
+		unsigned int p = penalty(qr);
+		if (p < best_penalty) {
+			best_penalty = p;
+			best_mask = mask;
+		}
+
+		apply_mask(qr, mask);
+	}
+
+	apply_mask(qr, best_mask);
+	draw_format(qr, format_bits[best_mask]);
+
+	for (int i = 0; i < qr->width * qr->width; i++)
+		qr->modules[i] &= DARK;
+
+	return 0;
+}
+
+int qrenc_encode(struct qrcode *qr, const char *str)
+{
+	size_t len = strlen(str);
+	if (len > CHARS_MAX)
+		return -1;
+
+	struct qrenc_segment segs[SEGMENTS_MAX];
+
+	// the character counts get longer after version 9, which can change
+	// the best split
+	static const int last_version[] = { 9, QRENC_VERSION_MAX };
+
+	for (size_t i = 0; i < sizeof(last_version) / sizeof(last_version[0]); i++) {
+		int version = last_version[i];
+
+		size_t count = split_segments(str, len, version, segs);
+		if (count == SIZE_MAX)
+			continue;
+
+		if (segments_bits(segs, count, version) <= 8 * data_codewords(&versions[version]))
+			return qrenc_encode_segments(qr, segs, count);
+	}
+
+	return -1;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// QR code encoder covering what the login URLs need: error correction level L,
+// numeric, alphanumeric and byte segments and versions up to QRENC_VERSION_MAX (69x69
+// modules, which still fits an 80 column terminal in UTF-8 mode)
+
+#define QRENC_VERSION_MAX 13
+#define QRENC_WIDTH_MAX (17 + 4 * QRENC_VERSION_MAX)
+
+enum qrenc_mode {
+	QRENC_MODE_NUMERIC,
+	QRENC_MODE_ALNUM,
+	QRENC_MODE_BYTE,
+};
+
+struct qrenc_segment {
+	enum qrenc_mode mode;
+	const char *data;
+	size_t len;
+};
+
+struct qrcode {
+	int version;
+	int width;
+	// width * width modules row by row, 1 for dark modules
+	uint8_t modules[QRENC_WIDTH_MAX * QRENC_WIDTH_MAX];
+};
+
+// true if c can be encoded in an alphanumeric segment
+bool qrenc_is_alnum(char c);
+
+// encodes the segments in the smallest version they fit in, -1 if they don't
+// fit in QRENC_VERSION_MAX or a segment has characters its mode can't encode
+int qrenc_encode_segments(struct qrcode *qr, const struct qrenc_segment *segs, size_t count);
+
+// encodes str split into the segments taking the fewest bits
+int qrenc_encode(struct qrcode *qr, const char *str);
@@ -13,6 +13,16 @@ from cryptography.hazmat.primitives.asymmetric.x25519 import X25519PrivateKey, X
 def decode_b64url(string):
     return base64.urlsafe_b64decode(string + '=') # FIXME
 
+# the compact URL format has the challenge as a fixed width little endian
+# decimal number
+CHALLENGE_DEC_LEN = 78
+
+def decode_challenge(string):
+    if len(string) == CHALLENGE_DEC_LEN and string.isdigit():
+        return int(string).to_bytes(32, 'little')
+
+    return decode_b64url(string)
+
 class Responder:
     def __init__(self, privkey: str):
         privkey_raw = decode_b64url(privkey)
@@ -22,7 +32,7 @@ class Responder:
         self.pubkey_raw = self.pubkey.public_bytes(encoding=Encoding.Raw, format=PublicFormat.Raw)
 
     def get_response(self, payload, challenge):
-        challenge_raw = decode_b64url(challenge)
+        challenge_raw = decode_challenge(challenge)
         peer_pub = X25519PublicKey.from_public_bytes(challenge_raw)
 
         dh_secret = self.privkey.exchange(peer_pub)
@@ -43,6 +53,12 @@ app = Flask(__name__)
 # public  Zng28LIYphqbbwqEfvcT4nAshzazNE5lDuSvRJjrSgQ
 responder = Responder('zGRMAXRoSKwMZG5EM-_B-s8oxTfICcfBiN1PAHCCqVo')
 
+# short names devices may show in the URL instead of their group (see the
+# group_alias option), they must not collide with actual group names
+group_aliases = {
+    'D': 'dev',
+}
+
 @app.route("/<node>/<user>/<challenge>")
 def get_standalone(node, user, challenge):
     payload = ("%s/%s" % (node, user)).encode('ascii')
@@ -52,6 +68,7 @@ def get_standalone(node, user, challenge):
 
 @app.route("/<group>/<node>/<user>/<challenge>")
 def get_grouped(group, node, user, challenge):
+    group = group_aliases.get(group, group)
     payload = b''.join(map(lambda x: x.encode('ascii') + b'\x00', [group, node, user]))
     code = responder.get_response(payload, challenge)
 
@@ -1,6 +1,12 @@
+#include <pthread.h>
 #include <stdint.h>
 #include <assert.h>
 
+#if defined(HAVE_SHANI) || defined(HAVE_AVX2)
+#include <immintrin.h>
+#endif
+
+#include "cpu.h"
 #include "utils.h"
 
 #include "sha256.h"
@@ -37,7 +43,7 @@ static const uint32_t K[64] = {
 #define Gamma1(x)       (S(x, 17) ^ S(x, 19) ^ R(x, 10))
 
 /* compress 512-bits */
-static void sha256_compress(struct sha256_state *md, const unsigned char *buf)
+static void sha256_compress_portable(uint32_t state[8], const unsigned char *buf)
 {
 	uint32_t S[8], W[64], t0, t1;
 	uint32_t t;
@@ -45,7 +51,7 @@ static void sha256_compress(struct sha256_state *md, const unsigned char *buf)
 
 	/* copy state into S */
 	for (i = 0; i < 8; i++) {
-		S[i] = md->state[i];
+		S[i] = state[i];
 	}
 
 	/* copy the state into 512-bits into W[0..15] */
@@ -74,10 +80,215 @@ static void sha256_compress(struct sha256_state *md, const unsigned char *buf)
 
 	/* feedback */
 	for (i = 0; i < 8; i++) {
-		md->state[i] = md->state[i] + S[i];
+		state[i] = state[i] + S[i];
+	}
+}
+
+#ifdef HAVE_SHANI
+#define SHANI __attribute__((target("sha,sse4.1")))
+
+/* compress 512-bits with the SHA extensions. sha256rnds2 performs two rounds
+ * on the state split into ABEF and CDGH, sha256msg1/sha256msg2 compute the
+ * message schedule four words at a time. */
+static SHANI void sha256_compress_shani(uint32_t state[8], const unsigned char *buf)
+{
+	const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m128i state0, state1, abef, cdgh, msg[4], w, t;
+
+	// DCBA, HGFE -> ABEF, CDGH
+	t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[0]), 0xb1);
+	state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&state[4]), 0x1b);
+	state0 = _mm_alignr_epi8(t, state1, 8);
+	state1 = _mm_blend_epi16(state1, t, 0xf0);
+
+	abef = state0;
+	cdgh = state1;
+
+#pragma GCC unroll 16
+	for (int i = 0; i < 16; i++) {
+		__m128i *cur = &msg[i % 4], *next = &msg[(i + 1) % 4];
+		__m128i *prev = &msg[(i + 3) % 4];
+
+		if (i < 4)
+			*cur = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buf + 16 * i)), bswap);
+
+		w = _mm_add_epi32(*cur, _mm_loadu_si128((const __m128i *)&K[4 * i]));
+		state1 = _mm_sha256rnds2_epu32(state1, state0, w);
+
+		// W[4i+4..4i+7], the sha256msg1 part was done three steps ago
+		if (i >= 3 && i < 15) {
+			*next = _mm_add_epi32(*next, _mm_alignr_epi8(*cur, *prev, 4));
+			*next = _mm_sha256msg2_epu32(*next, *cur);
+		}
+
+		w = _mm_shuffle_epi32(w, 0x0e);
+		state0 = _mm_sha256rnds2_epu32(state0, state1, w);
+
+		if (i >= 1 && i < 13)
+			*prev = _mm_sha256msg1_epu32(*prev, *cur);
+	}
+
+	state0 = _mm_add_epi32(state0, abef);
+	state1 = _mm_add_epi32(state1, cdgh);
+
+	// ABEF, CDGH -> DCBA, HGFE
+	t = _mm_shuffle_epi32(state0, 0x1b);
+	state1 = _mm_shuffle_epi32(state1, 0xb1);
+	state0 = _mm_blend_epi16(t, state1, 0xf0);
+	state1 = _mm_alignr_epi8(state1, t, 8);
+
+	_mm_storeu_si128((__m128i *)&state[0], state0);
+	_mm_storeu_si128((__m128i *)&state[4], state1);
+}
+#endif
+
+typedef void compress_fn(uint32_t state[8], const unsigned char *buf);
+typedef void compress_lanes_fn(uint32_t *const state[SHA256_LANES], const unsigned char *const buf[SHA256_LANES]);
+
+// selected by sha256_dispatch, or for the CPU on the first compression
+static compress_fn *compress_impl = sha256_compress_portable;
+static pthread_once_t dispatch_once = PTHREAD_ONCE_INIT;
+
+static int dispatch_select(unsigned int cpu);
+
+static void dispatch_load(void)
+{
+	dispatch_select(cpu_features());
+}
+
+static void sha256_compress(uint32_t state[8], const unsigned char *buf)
+{
+	pthread_once(&dispatch_once, dispatch_load);
+	compress_impl(state, buf);
+}
+
+/* compress one block in each of SHA256_LANES independent states, lanes with a
+ * NULL state are skipped */
+static void sha256_compress_lanes_serial(uint32_t *const state[SHA256_LANES],
+                                         const unsigned char *const buf[SHA256_LANES])
+{
+	for (int l = 0; l < SHA256_LANES; l++) {
+		if (state[l])
+			sha256_compress(state[l], buf[l]);
 	}
 }
 
+#ifdef HAVE_AVX2
+#define AVX2 __attribute__((target("avx2")))
+
+#define ROR8(x, n) _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - (n)))
+#define Sigma0_8(x) _mm256_xor_si256(_mm256_xor_si256(ROR8(x, 2), ROR8(x, 13)), ROR8(x, 22))
+#define Sigma1_8(x) _mm256_xor_si256(_mm256_xor_si256(ROR8(x, 6), ROR8(x, 11)), ROR8(x, 25))
+#define Gamma0_8(x) _mm256_xor_si256(_mm256_xor_si256(ROR8(x, 7), ROR8(x, 18)), _mm256_srli_epi32(x, 3))
+#define Gamma1_8(x) _mm256_xor_si256(_mm256_xor_si256(ROR8(x, 17), ROR8(x, 19)), _mm256_srli_epi32(x, 10))
+
+/* transposes the 8x8 matrix of 32 bit words in r */
+static AVX2 inline void transpose8(__m256i r[8])
+{
+	__m256i t[8], u[8];
+
+	for (int i = 0; i < 4; i++) {
+		t[2*i] = _mm256_unpacklo_epi32(r[2*i], r[2*i+1]);
+		t[2*i+1] = _mm256_unpackhi_epi32(r[2*i], r[2*i+1]);
+	}
+
+	for (int i = 0; i < 2; i++) {
+		u[4*i] = _mm256_unpacklo_epi64(t[4*i], t[4*i+2]);
+		u[4*i+1] = _mm256_unpackhi_epi64(t[4*i], t[4*i+2]);
+		u[4*i+2] = _mm256_unpacklo_epi64(t[4*i+1], t[4*i+3]);
+		u[4*i+3] = _mm256_unpackhi_epi64(t[4*i+1], t[4*i+3]);
+	}
+
+	for (int i = 0; i < 4; i++) {
+		r[i] = _mm256_permute2x128_si256(u[i], u[i+4], 0x20);
+		r[i+4] = _mm256_permute2x128_si256(u[i], u[i+4], 0x31);
+	}
+}
+
+/* as sha256_compress_lanes_serial, but with the eight lanes of AVX2 registers
+ * (one register holds word i of every lane) */
+static AVX2 void sha256_compress_lanes_avx2(uint32_t *const state[SHA256_LANES],
+                                            const unsigned char *const buf[SHA256_LANES])
+{
+	static const uint8_t zero_block[SHA256_BLOCK_SIZE];
+	const __m256i bswap = _mm256_set_epi8(
+		12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+		12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3
+	);
+	uint32_t scratch[8] = {0};
+	uint32_t *st[SHA256_LANES];
+	const unsigned char *in[SHA256_LANES];
+	__m256i S[8], V[8], W[16];
+
+	for (int l = 0; l < SHA256_LANES; l++) {
+		st[l] = state[l] ? state[l] : scratch;
+		in[l] = state[l] ? buf[l] : zero_block;
+		S[l] = _mm256_loadu_si256((const __m256i *)st[l]);
+	}
+	transpose8(S);
+
+	for (int half = 0; half < 2; half++) {
+		for (int l = 0; l < SHA256_LANES; l++) {
+			__m256i row = _mm256_loadu_si256((const __m256i *)(in[l] + 32 * half));
+			W[8 * half + l] = _mm256_shuffle_epi8(row, bswap);
+		}
+		transpose8(&W[8 * half]);
+	}
+
+	for (int i = 0; i < 8; i++)
+		V[i] = S[i];
+
+	for (int i = 0; i < 64; i += 16) {
+#pragma GCC unroll 16
+		for (int j = 0; j < 16; j++) {
+			__m256i a = V[0], b = V[1], c = V[2], d = V[3];
+			__m256i e = V[4], f = V[5], g = V[6], h = V[7];
+			__m256i t0, t1;
+
+			if (i > 0) {
+				W[j] = _mm256_add_epi32(
+					_mm256_add_epi32(Gamma1_8(W[(j + 14) % 16]), W[(j + 9) % 16]),
+					_mm256_add_epi32(Gamma0_8(W[(j + 1) % 16]), W[j])
+				);
+			}
+
+			// Ch(e, f, g) and Maj(a, b, c) as in the portable code
+			t0 = _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g)));
+			t0 = _mm256_add_epi32(_mm256_add_epi32(h, Sigma1_8(e)), t0);
+			t0 = _mm256_add_epi32(t0, _mm256_add_epi32(_mm256_set1_epi32(K[i + j]), W[j]));
+			t1 = _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(a, b), c), _mm256_and_si256(a, b));
+			t1 = _mm256_add_epi32(Sigma0_8(a), t1);
+
+			V[7] = g;
+			V[6] = f;
+			V[5] = e;
+			V[4] = _mm256_add_epi32(d, t0);
+			V[3] = c;
+			V[2] = b;
+			V[1] = a;
+			V[0] = _mm256_add_epi32(t0, t1);
+		}
+	}
+
+	for (int i = 0; i < 8; i++)
+		S[i] = _mm256_add_epi32(S[i], V[i]);
+	transpose8(S);
+
+	for (int l = 0; l < SHA256_LANES; l++)
+		_mm256_storeu_si256((__m256i *)st[l], S[l]);
+}
+#endif
+
+// selected along with compress_impl
+static compress_lanes_fn *compress_lanes_impl = sha256_compress_lanes_serial;
+
+static void sha256_compress_lanes(uint32_t *const state[SHA256_LANES],
+                                  const unsigned char *const buf[SHA256_LANES])
+{
+	pthread_once(&dispatch_once, dispatch_load);
+	compress_lanes_impl(state, buf);
+}
+
 void sha256_init(struct sha256_state *md)
 {
 	md->curlen = 0;
@@ -101,7 +312,7 @@ void sha256_process(struct sha256_state *md, const unsigned char *in, unsigned l
 
 	while (inlen > 0) {
 		if (md->curlen == 0 && inlen >= SHA256_BLOCK_SIZE) {
-			sha256_compress(md, in);
+			sha256_compress(md->state, in);
 			md->length += SHA256_BLOCK_SIZE * 8;
 			in += SHA256_BLOCK_SIZE;
 			inlen -= SHA256_BLOCK_SIZE;
@@ -112,7 +323,7 @@ void sha256_process(struct sha256_state *md, const unsigned char *in, unsigned l
 			in += n;
 			inlen -= n;
 			if (md->curlen == SHA256_BLOCK_SIZE) {
-				sha256_compress(md, md->buf);
+				sha256_compress(md->state, md->buf);
 				md->length += 8*SHA256_BLOCK_SIZE;
 				md->curlen = 0;
 			}
@@ -140,7 +351,7 @@ void sha256_finish(struct sha256_state *md, unsigned char *out)
 		while (md->curlen < 64) {
 			md->buf[md->curlen++] = (unsigned char)0;
 		}
-		sha256_compress(md, md->buf);
+		sha256_compress(md->state, md->buf);
 		md->curlen = 0;
 	}
 
@@ -151,7 +362,7 @@ void sha256_finish(struct sha256_state *md, unsigned char *out)
 
 	/* store length */
 	p64be(md->buf+56, md->length);
-	sha256_compress(md, md->buf);
+	sha256_compress(md->state, md->buf);
 
 	/* copy output */
 	for (i = 0; i < 8; i++) {
@@ -159,6 +370,11 @@ void sha256_finish(struct sha256_state *md, unsigned char *out)
 	}
 }
 
+void sha256_process_block(struct sha256_state *md, const unsigned char block[SHA256_BLOCK_SIZE])
+{
+	sha256_compress(md->state, block);
+}
+
 void sha256(unsigned char *out, const unsigned char *in, unsigned long inlen)
 {
 	struct sha256_state md;
@@ -167,3 +383,187 @@ void sha256(unsigned char *out, const unsigned char *in, unsigned long inlen)
 	sha256_process(&md, in, inlen);
 	sha256_finish(&md, out);
 }
+
+void sha256_process_batch(struct sha256_state *md, const unsigned char *const *in,
+                          const size_t *inlen, size_t count)
+{
+	for (size_t base = 0; base < count; base += SHA256_LANES) {
+		size_t lanes = MIN(count - base, SHA256_LANES);
+		const unsigned char *p[SHA256_LANES];
+		size_t left[SHA256_LANES];
+
+		for (size_t l = 0; l < lanes; l++) {
+			assert(md[base+l].curlen <= sizeof(md[base+l].buf));
+			assert((md[base+l].length + inlen[base+l] * 8) >= md[base+l].length);
+
+			p[l] = in[base+l];
+			left[l] = inlen[base+l];
+		}
+
+		// compress the next block of every lane that has one in lockstep
+		for (;;) {
+			uint32_t *state[SHA256_LANES] = {0};
+			const unsigned char *blocks[SHA256_LANES] = {0};
+			size_t active = 0, last = 0;
+
+			for (size_t l = 0; l < lanes; l++) {
+				struct sha256_state *s = &md[base+l];
+
+				if (s->curlen == 0 && left[l] >= SHA256_BLOCK_SIZE) {
+					blocks[l] = p[l];
+					p[l] += SHA256_BLOCK_SIZE;
+					left[l] -= SHA256_BLOCK_SIZE;
+				} else if (s->curlen + left[l] >= SHA256_BLOCK_SIZE) {
+					size_t n = SHA256_BLOCK_SIZE - s->curlen;
+
+					memcpy(s->buf + s->curlen, p[l], n);
+					p[l] += n;
+					left[l] -= n;
+					s->curlen = 0;
+					blocks[l] = s->buf;
+				} else {
+					continue;
+				}
+
+				state[l] = s->state;
+				s->length += SHA256_BLOCK_SIZE * 8;
+				active++;
+				last = l;
+			}
+
+			if (active == 0)
+				break;
+			else if (active == 1)
+				sha256_compress(state[last], blocks[last]);
+			else
+				sha256_compress_lanes(state, blocks);
+		}
+
+		for (size_t l = 0; l < lanes; l++) {
+			struct sha256_state *s = &md[base+l];
+
+			memcpy(s->buf + s->curlen, p[l], left[l]);
+			s->curlen += left[l];
+		}
+	}
+}
+
+void sha256_finish_batch(struct sha256_state *md, unsigned char (*out)[SHA256_SIZE], size_t count)
+{
+	for (size_t base = 0; base < count; base += SHA256_LANES) {
+		size_t lanes = MIN(count - base, SHA256_LANES);
+		unsigned char pad[SHA256_LANES][2 * SHA256_BLOCK_SIZE];
+		const unsigned char *p[SHA256_LANES];
+		size_t padlen[SHA256_LANES];
+
+		// the '1' bit, zeros and the length, as in sha256_finish
+		for (size_t l = 0; l < lanes; l++) {
+			struct sha256_state *s = &md[base+l];
+			uint64_t length = s->length + s->curlen * 8;
+
+			assert(s->curlen < sizeof(s->buf));
+
+			padlen[l] = (s->curlen < 56 ? SHA256_BLOCK_SIZE : 2 * SHA256_BLOCK_SIZE) - s->curlen;
+			memset(pad[l], 0, padlen[l]);
+			pad[l][0] = 0x80;
+			p64be(pad[l] + padlen[l] - 8, length);
+			p[l] = pad[l];
+		}
+
+		sha256_process_batch(&md[base], p, padlen, lanes);
+
+		for (size_t l = 0; l < lanes; l++) {
+			for (int i = 0; i < 8; i++)
+				p32be(out[base+l] + 4*i, md[base+l].state[i]);
+		}
+	}
+}
+
+/* checks a compression function against a known answer, the padded message
+ * "abc" of FIPS 180-2, Appendix B.1 */
+static int compress_selftest(compress_fn *compress)
+{
+	static const uint32_t expected[8] = {
+		0xba7816bf, 0x8f01cfea, 0x414140de, 0x5dae2223, 0xb00361a3, 0x96177a9c, 0xb410ff61, 0xf20015ad
+	};
+	unsigned char block[SHA256_BLOCK_SIZE] = "abc\x80";
+	struct sha256_state md;
+
+	block[SHA256_BLOCK_SIZE - 1] = 3 * 8;
+	sha256_init(&md);
+	compress(md.state, block);
+
+	return memcmp(md.state, expected, sizeof(expected)) == 0 ? 0 : -1;
+}
+
+/* checks a lanes function against the portable compression, with a different
+ * state and block in each lane and one lane without a state */
+static int compress_lanes_selftest(compress_lanes_fn *compress_lanes)
+{
+	unsigned char block[SHA256_LANES][SHA256_BLOCK_SIZE];
+	uint32_t out[SHA256_LANES][8], expected[SHA256_LANES][8];
+	uint32_t *state[SHA256_LANES];
+	const unsigned char *buf[SHA256_LANES];
+
+	for (int l = 0; l < SHA256_LANES; l++) {
+		for (int i = 0; i < SHA256_BLOCK_SIZE; i++)
+			block[l][i] = (unsigned char)(l * SHA256_BLOCK_SIZE + i);
+
+		for (int i = 0; i < 8; i++)
+			out[l][i] = expected[l][i] = 0x9e3779b9u * (l * 8 + i + 1);
+
+		state[l] = l == 3 ? NULL : out[l];
+		buf[l] = block[l];
+		if (state[l])
+			sha256_compress_portable(expected[l], block[l]);
+	}
+
+	compress_lanes(state, buf);
+
+	return memcmp(out, expected, sizeof(expected)) == 0 ? 0 : -1;
+}
+
+/* selects the implementations without going through sha256_compress, only
+ * the selected ones are checked */
+static int dispatch_select(unsigned int cpu)
+{
+	compress_fn *compress = sha256_compress_portable;
+	compress_lanes_fn *compress_lanes = sha256_compress_lanes_serial;
+	int ret = 0;
+
+#ifdef HAVE_SHANI
+	if (cpu & CPU_SHA) {
+		if (compress_selftest(sha256_compress_shani) == 0)
+			compress = sha256_compress_shani;
+		else
+			ret = -1;
+	}
+#endif
+
+	// the portable code has to work in any case
+	if (compress == sha256_compress_portable && compress_selftest(compress) != 0)
+		ret = -1;
+
+#ifdef HAVE_AVX2
+	// one SHA extensions compression per lane beats eight AVX2 lanes
+	if ((cpu & CPU_AVX2) && !(cpu & CPU_SHA)) {
+		if (compress_lanes_selftest(sha256_compress_lanes_avx2) == 0)
+			compress_lanes = sha256_compress_lanes_avx2;
+		else
+			ret = -1;
+	}
+#endif
+
+	compress_impl = compress;
+	compress_lanes_impl = compress_lanes;
+
+	return ret;
+}
+
+int sha256_dispatch(unsigned int cpu)
+{
+	// the first compression would undo this otherwise
+	pthread_once(&dispatch_once, dispatch_load);
+
+	return dispatch_select(cpu);
+}
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 
 #define SHA256_BLOCK_SIZE 64
 #define SHA256_SIZE 32
 
+// number of messages hashed in parallel by the batch functions
+#define SHA256_LANES 8
+
 struct sha256_state {
 	uint64_t length;
 	uint32_t state[8], curlen;
@@ -16,3 +20,21 @@ void sha256_process(struct sha256_state *md, const unsigned char *in,
                    unsigned long inlen);
 void sha256_finish(struct sha256_state *md, unsigned char *out);
 void sha256(unsigned char *out, const unsigned char *in, unsigned long inlen);
+
+// compresses a single block into md->state, bypassing the buffering (and the
+// length accounting) of sha256_process, for callers that pad on their own
+void sha256_process_block(struct sha256_state *md, const unsigned char block[SHA256_BLOCK_SIZE]);
+
+// sha256_process and sha256_finish for count independent states md[i], with
+// SHA256_LANES of them compressed at once if the CPU supports it
+void sha256_process_batch(struct sha256_state *md, const unsigned char *const *in,
+                          const size_t *inlen, size_t count);
+void sha256_finish_batch(struct sha256_state *md, unsigned char (*out)[SHA256_SIZE], size_t count);
+
+// selects the implementation for the given CPU features (see cpu.h) and
+// checks it against known answers. This happens for cpu_features() on the
+// first compression, calling it explicitly (e.g. in tests) must not race with
+// hashing in other threads.
+//
+// Returns -1 if a self-test failed.
+int sha256_dispatch(unsigned int cpu);
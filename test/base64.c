@@ -8,6 +8,7 @@
 #include <cmocka.h>
 
 #include "base64.h"
+#include "cpu.h"
 
 static void test_encode(void **state)
 {
@@ -97,6 +98,110 @@ static void test_decode(void **state)
 	}
 }
 
+// the CPU features b64url_dispatch is run with, the portable code is last
+static const unsigned int backends[] = { ~0u, CPU_SSE41, 0 };
+
+static void test_backends_agree(void **state)
+{
+	(void) state;
+
+	// all lengths up to several vector blocks, compared against the portable
+	// code selected last
+	static const char invalid[] = { '+', '/', '=', ' ', '@', '`', '{', ':', '.', '\x80', '\xdf' };
+	uint8_t raw[100], out[100];
+	char enc[2][140];
+
+	for (size_t i = 0; i < sizeof(raw); i++)
+		raw[i] = (uint8_t)(i * 73 + 11);
+
+	for (size_t len = 0; len <= sizeof(raw); len++) {
+		ssize_t short_ret[sizeof(backends) / sizeof(backends[0])] = {0};
+
+		for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+			assert_int_equal(b64url_dispatch(cpu_features() & backends[b]), 0);
+
+			b64url_enc(enc[b % 2], raw, len);
+			if (b > 0)
+				assert_string_equal(enc[0], enc[1]);
+
+			assert_int_equal(b64url_dec(out, sizeof(out), enc[b % 2]), len);
+			assert_memory_equal(out, raw, len);
+
+			// too little space, which the portable code accepts if the
+			// bits that do not fit are zero, all have to agree
+			if (len > 0)
+				short_ret[b] = b64url_dec(out, len - 1, enc[b % 2]);
+
+			// every position of the encoding with invalid characters
+			char bad[140];
+			size_t enc_len = strlen(enc[b % 2]);
+			for (size_t i = 0; i < enc_len; i++) {
+				memcpy(bad, enc[b % 2], enc_len + 1);
+				bad[i] = invalid[i % sizeof(invalid)];
+
+				assert_int_equal(b64url_dec(out, sizeof(out), bad), -1);
+			}
+		}
+
+		for (size_t b = 1; b < sizeof(backends) / sizeof(backends[0]); b++)
+			assert_int_equal(short_ret[b], short_ret[0]);
+	}
+}
+
+static void test_dec32_batch(void **state)
+{
+	(void) state;
+
+#define COUNT 9
+	uint8_t raw[COUNT][32], out[COUNT][32];
+	char enc[COUNT][B64URL_LEN32 + 1];
+	const char *in[COUNT];
+	bool valid[COUNT];
+
+	for (size_t i = 0; i < COUNT; i++) {
+		for (size_t j = 0; j < 32; j++)
+			raw[i][j] = (uint8_t)(i * 32 + j * 9);
+
+		b64url_enc(enc[i], raw[i], 32);
+		in[i] = enc[i];
+	}
+
+	// invalid characters at the start, in the vector tail and at the end,
+	// and excess bits in the last character
+	enc[2][0] = '/';
+	enc[4][40] = '=';
+	enc[5][42] = '+';
+	enc[7][42] = 'B';
+
+	for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+		assert_int_equal(b64url_dispatch(cpu_features() & backends[b]), 0);
+
+		memset(out, 0, sizeof(out));
+		assert_int_equal(b64url_dec32_batch(out, valid, in, COUNT), COUNT - 4);
+
+		for (size_t i = 0; i < COUNT; i++) {
+			uint8_t single[32];
+			bool expected = b64url_dec(single, sizeof(single), enc[i]) == 32;
+
+			assert_int_equal(valid[i], expected);
+			assert_int_equal(valid[i], i != 2 && i != 4 && i != 5 && i != 7);
+			if (valid[i])
+				assert_memory_equal(out[i], raw[i], 32);
+		}
+	}
+#undef COUNT
+}
+
+static void test_dispatch(void **state)
+{
+	(void) state;
+
+	// both the implementation selected for this CPU and the portable one
+	// pass their self-test
+	assert_int_equal(b64url_dispatch(cpu_features()), 0);
+	assert_int_equal(b64url_dispatch(0), 0);
+}
+
 int main(int argc, char **argv)
 {
 	(void) argc;
@@ -105,6 +210,9 @@ int main(int argc, char **argv)
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test(test_encode),
 		cmocka_unit_test(test_decode),
+		cmocka_unit_test(test_backends_agree),
+		cmocka_unit_test(test_dec32_batch),
+		cmocka_unit_test(test_dispatch),
 	};
 
 	return cmocka_run_group_tests_name("base64", tests, NULL, NULL);
@@ -8,6 +8,7 @@
 #include <cmocka.h>
 
 #include "challenge.h"
+#include "tweetnacl.h"
 #include "utils.h"
 
 static size_t randombytes_len = 0;
@@ -59,7 +60,7 @@ static void test_challenge(void **state)
 		"dev", "SSSN7PBXFG6DY", "root", NULL
 	};
 
-	_ = make_challenge(pubkey, payload, challenge, response);
+	_ = make_challenge(pubkey, NULL, payload, challenge, response);
 	assert_int_equal(_, 0);
 
 	uint8_t expected_challenge[] = {
@@ -75,6 +76,104 @@ static void test_challenge(void **state)
 	assert_memory_equal(response, expected_response, 32);
 }
 
+static void test_challenge_split(void **state)
+{
+	(void) state;
+	int _;
+
+	// the example from the documentation again, see test_challenge
+	uint8_t pubkey[] = {
+		0x66, 0x78, 0x36, 0xf0, 0xb2, 0x18, 0xa6, 0x1a, 0x9b, 0x6f, 0x0a, 0x84, 0x7e, 0xf7, 0x13, 0xe2,
+		0x70, 0x2c, 0x87, 0x36, 0xb3, 0x34, 0x4e, 0x65, 0x0e, 0xe4, 0xaf, 0x44, 0x98, 0xeb, 0x4a, 0x04
+	};
+
+	uint8_t nonce[] = {
+		0x3e, 0x2a, 0x27, 0xbe, 0xc0, 0x47, 0x58, 0x54, 0x6b, 0x5c, 0xd2, 0x93, 0x1b, 0x80, 0x9d, 0x56,
+		0xf3, 0x82, 0xe8, 0x10, 0x52, 0x6c, 0x3a, 0xe1, 0xcc, 0x61, 0xf8, 0x61, 0xe5, 0x86, 0x93, 0x5f
+	};
+
+	const char *payload[] = {
+		"dev", "SSSN7PBXFG6DY", "root", NULL
+	};
+
+	uint8_t expected_challenge[32], expected_response[32];
+	randombytes_set(nonce, sizeof(nonce));
+	_ = make_challenge(pubkey, NULL, payload, expected_challenge, expected_response);
+	assert_int_equal(_, 0);
+
+	struct pending_challenge pending;
+	uint8_t challenge[32], response[32];
+
+	randombytes_set(nonce, sizeof(nonce));
+	_ = challenge_begin(&pending, challenge);
+	assert_int_equal(_, 0);
+	assert_memory_equal(challenge, expected_challenge, 32);
+
+	_ = challenge_respond(&pending, pubkey, NULL, payload, response);
+	assert_int_equal(_, 0);
+	assert_memory_equal(response, expected_response, 32);
+
+	// the nonce is gone
+	static const uint8_t zero[32];
+	assert_memory_equal(pending.secret, zero, 32);
+}
+
+static void test_responses(void **state)
+{
+	(void) state;
+	int _;
+
+#define COUNT 19
+	uint8_t privkey[32], pubkey[32];
+	for (size_t i = 0; i < sizeof(privkey); i++)
+		privkey[i] = (uint8_t)(i * 7 + 1);
+	crypto_scalarmult_base(pubkey, privkey);
+
+	// the last one makes the login data too long for hmac_short
+	static const char *const hosts[] = { "a", "SSSN7PBXFG6DY", "a-rather-long-host-name.in-a-subdomain.example.com" };
+	const char *payload[COUNT][4];
+	const char **payloads[COUNT];
+	uint8_t challenges[COUNT][32], expected[COUNT][32], responses[COUNT][32];
+
+	// the device side, with payloads of different lengths
+	for (size_t i = 0; i < COUNT; i++) {
+		uint8_t nonce[32];
+		memset(nonce, (int)i + 1, sizeof(nonce));
+		randombytes_set(nonce, sizeof(nonce));
+
+		payload[i][0] = "dev";
+		payload[i][1] = hosts[i % 3];
+		payload[i][2] = (i % 2) ? "root" : "user";
+		payload[i][3] = NULL;
+		payloads[i] = payload[i];
+
+		_ = make_challenge(pubkey, NULL, payload[i], challenges[i], expected[i]);
+		assert_int_equal(_, 0);
+	}
+
+	_ = make_responses(privkey, &challenges[0][0], payloads, responses, COUNT);
+	assert_int_equal(_, 0);
+
+	for (size_t i = 0; i < COUNT; i++)
+		assert_memory_equal(responses[i], expected[i], 32);
+
+	// no challenges, and one with an empty payload
+	_ = make_responses(privkey, &challenges[0][0], payloads, responses, 0);
+	assert_int_equal(_, 0);
+
+	const char *empty[] = {NULL};
+	const char **empty_payloads[] = {empty};
+	uint8_t nonce[32] = {0};
+
+	randombytes_set(nonce, sizeof(nonce));
+	_ = make_challenge(pubkey, NULL, empty, challenges[0], expected[0]);
+	assert_int_equal(_, 0);
+	_ = make_responses(privkey, &challenges[0][0], empty_payloads, responses, 1);
+	assert_int_equal(_, 0);
+	assert_memory_equal(responses[0], expected[0], 32);
+#undef COUNT
+}
+
 static void test_code(void **state)
 {
 	(void) state;
@@ -86,9 +185,36 @@ static void test_code(void **state)
 		0x0a, 0x98, 0xb3, 0x7f, 0x5b, 0x99, 0xd2, 0x18, 0x9d, 0xb7, 0xae, 0xb3, 0xd4, 0x36, 0xde, 0x50
 	};
 
-	AUTOFREE_PTR(char, code);
-	code = response_to_code(response, 9);
+	char code[10];
+	assert_int_equal(response_to_code(response, 9, code, sizeof(code)), 0);
 	assert_string_equal(code, "552159108");
+
+	assert_int_equal(response_to_code(response, 9, code, sizeof(code) - 1), -1);
+	assert_int_equal(response_to_code(response, 20, code, sizeof(code)), -1);
+}
+
+static void test_decimal(void **state)
+{
+	(void) state;
+
+	// the challenge from the documentation and the extremes
+	uint8_t challenge[] = {
+		0x73, 0x60, 0xda, 0xa5, 0x23, 0xa5, 0x68, 0x14, 0xfd, 0x97, 0x43, 0x8c, 0xa1, 0x83, 0xe4, 0xe0,
+		0xf8, 0x57, 0xc1, 0xde, 0x7f, 0x92, 0xcc, 0x5a, 0xd7, 0x4f, 0x6a, 0xf9, 0xec, 0x23, 0xed, 0x5a
+	};
+
+	char out[CHALLENGE_DEC_LEN + 1];
+	challenge_to_decimal(challenge, out);
+	assert_string_equal(out, "041127147076782497953142476407891014659948021277234225654024133224789119230067");
+
+	memset(challenge, 0xff, sizeof(challenge));
+	challenge_to_decimal(challenge, out);
+	assert_string_equal(out, "115792089237316195423570985008687907853269984665640564039457584007913129639935");
+
+	memset(challenge, 0, sizeof(challenge));
+	challenge[0] = 1;
+	challenge_to_decimal(challenge, out);
+	assert_string_equal(out, "000000000000000000000000000000000000000000000000000000000000000000000000000001");
 }
 
 static void test_phrase(void **state)
@@ -102,9 +228,13 @@ static void test_phrase(void **state)
 		0x0a, 0x98, 0xb3, 0x7f, 0x5b, 0x99, 0xd2, 0x18, 0x9d, 0xb7, 0xae, 0xb3, 0xd4, 0x36, 0xde, 0x50
 	};
 
-	AUTOFREE_PTR(char, phrase);
-	phrase = response_to_phrase(response, 5);
+	char phrase[RESPONSE_SIZE_MAX];
+	assert_int_equal(response_to_phrase(response, 5, phrase, sizeof(phrase)), 0);
 	assert_string_equal(phrase, "correct horse pottery maple idle");
+
+	assert_int_equal(response_to_phrase(response, 23, phrase, sizeof(phrase)), 0);
+	assert_int_equal(response_to_phrase(response, 24, phrase, sizeof(phrase)), -1);
+	assert_int_equal(response_to_phrase(response, 5, phrase, 5 * 8), -1);
 }
 
 int main(int argc, char **argv)
@@ -114,7 +244,10 @@ int main(int argc, char **argv)
 
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test(test_challenge),
+		cmocka_unit_test(test_challenge_split),
+		cmocka_unit_test(test_responses),
 		cmocka_unit_test(test_code),
+		cmocka_unit_test(test_decimal),
 		cmocka_unit_test(test_phrase),
 	};
 
@@ -7,6 +7,7 @@
 
 #include <cmocka.h>
 
+#include "cpu.h"
 #include "hmac.h"
 
 static void test_hmac_rfc4231(void **state)
@@ -81,6 +82,64 @@ static void test_hmac_rfc4231(void **state)
 	}
 }
 
+static void test_hmac_short(void **state)
+{
+	(void) state;
+
+	uint8_t key[32], msg[HMAC_SHORT_MAX];
+	for (size_t i = 0; i < sizeof(key); i++)
+		key[i] = (uint8_t)(i * 37 + 3);
+	for (size_t i = 0; i < sizeof(msg); i++)
+		msg[i] = (uint8_t)(i * 11 + 5);
+
+	for (size_t len = 0; len <= HMAC_SHORT_MAX; len++) {
+		uint8_t out[SHA256_SIZE], expected[SHA256_SIZE];
+
+		hmac(expected, key, sizeof(key), msg, len);
+		hmac_short(out, key, msg, len);
+		assert_memory_equal(out, expected, SHA256_SIZE);
+	}
+}
+
+static void test_hmac_batch(void **state)
+{
+	(void) state;
+
+#define COUNT (SHA256_LANES + 5)
+	// key lengths below, at and above the block size
+	static const size_t key_lens[] = { 20, 32, 64, 131 };
+
+	uint8_t keys[COUNT * 131], msg[200];
+	for (size_t i = 0; i < sizeof(keys); i++)
+		keys[i] = (uint8_t)(i * 37 + 3);
+	for (size_t i = 0; i < sizeof(msg); i++)
+		msg[i] = (uint8_t)(i * 11 + 5);
+
+	assert_int_equal(sha256_dispatch(cpu_features()), 0);
+
+	for (size_t k = 0; k < sizeof(key_lens) / sizeof(key_lens[0]); k++) {
+		size_t key_len = key_lens[k];
+		const uint8_t *data[COUNT];
+		size_t data_len[COUNT];
+		uint8_t out[COUNT][SHA256_SIZE];
+
+		for (size_t i = 0; i < COUNT; i++) {
+			data[i] = msg + i;
+			data_len[i] = (i * 29) % (sizeof(msg) - COUNT);
+		}
+
+		hmac_batch(out, keys, key_len, data, data_len, COUNT);
+
+		for (size_t i = 0; i < COUNT; i++) {
+			uint8_t expected[SHA256_SIZE];
+
+			hmac(expected, keys + i * key_len, key_len, data[i], data_len[i]);
+			assert_memory_equal(out[i], expected, SHA256_SIZE);
+		}
+	}
+#undef COUNT
+}
+
 int main(int argc, char **argv)
 {
 	(void) argc;
@@ -88,6 +147,8 @@ int main(int argc, char **argv)
 
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test(test_hmac_rfc4231),
+		cmocka_unit_test(test_hmac_short),
+		cmocka_unit_test(test_hmac_batch),
 	};
 
 	return cmocka_run_group_tests_name("hash", tests, NULL, NULL);
@@ -0,0 +1,156 @@
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include <cmocka.h>
+
+#include "pool.h"
+#include "tweetnacl.h"
+#include "utils.h"
+
+#define POOL_SIZE 4
+#define HEADER_SIZE 64
+#define SLOT_SIZE 96
+#define CREATED_OFFSET 48
+#define SLOT_CLAIMED 3
+
+static uint8_t random_counter;
+
+int randombytes(uint8_t *out, size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+		out[i] = random_counter * 31 + i;
+
+	random_counter++;
+
+	return 0;
+}
+
+static void check_claim(const char *path, const uint8_t privkey[static 32], const uint8_t pubkey[static 32])
+{
+	uint8_t challenge[32], dh_shared[32], expected[32];
+
+	assert_int_equal(pool_claim(path, pubkey, challenge, dh_shared), 0);
+
+	// the responder derives the same secret from the challenge
+	crypto_scalarmult(expected, privkey, challenge);
+	assert_memory_equal(dh_shared, expected, 32);
+}
+
+static void poke(const char *path, off_t offset, const void *data, size_t len)
+{
+	FILE *f = fopen(path, "r+b");
+	assert_non_null(f);
+	assert_int_equal(fseek(f, offset, SEEK_SET), 0);
+	assert_int_equal(fwrite(data, len, 1, f), 1);
+	fclose(f);
+}
+
+static void test_pool(void **state)
+{
+	(void) state;
+
+	// the pool is only accepted if it is owned by root
+	if (geteuid() != 0)
+		skip();
+
+	char dir[] = "/tmp/pbotp-pool-test.XXXXXX";
+	assert_non_null(mkdtemp(dir));
+
+	char path[64];
+	snprintf(path, sizeof(path), "%s/pool", dir);
+
+	uint8_t privkey[32], pubkey[32], other[32];
+	uint8_t challenge[32], dh_shared[32];
+
+	for (size_t i = 0; i < 32; i++)
+		privkey[i] = i;
+	crypto_scalarmult_base(pubkey, privkey);
+	privkey[1]++;
+	crypto_scalarmult_base(other, privkey);
+	privkey[1]--;
+
+	assert_int_equal(pool_claim(path, pubkey, challenge, dh_shared), -1);
+
+	assert_int_equal(pool_fill(path, pubkey, POOL_SIZE, NULL), POOL_SIZE);
+	assert_int_equal(pool_fill(path, pubkey, POOL_SIZE, NULL), 0);
+
+	struct stat st;
+	assert_int_equal(stat(path, &st), 0);
+	assert_int_equal(st.st_mode & 0777, 0600);
+
+	assert_int_equal(pool_claim(path, other, challenge, dh_shared), -1);
+
+	for (int i = 0; i < POOL_SIZE; i++)
+		check_claim(path, privkey, pubkey);
+
+	assert_int_equal(pool_claim(path, pubkey, challenge, dh_shared), -1);
+
+	// all claimed slots have been wiped
+	FILE *f = fopen(path, "rb");
+	assert_non_null(f);
+	assert_int_equal(fseek(f, HEADER_SIZE, SEEK_SET), 0);
+
+	int c;
+	size_t slot_bytes = 0;
+	while ((c = fgetc(f)) != EOF) {
+		assert_int_equal(c, 0);
+		slot_bytes++;
+	}
+	fclose(f);
+	assert_int_equal(slot_bytes, POOL_SIZE * 96);
+
+	// refilling continues where the cursor is
+	assert_int_equal(pool_fill(path, pubkey, POOL_SIZE, NULL), POOL_SIZE);
+	check_claim(path, privkey, pubkey);
+	assert_int_equal(pool_fill(path, pubkey, POOL_SIZE, NULL), 1);
+
+	// slots left claimed by a claimer that died are recovered by the filler
+	// once the claim has timed out, immediately if it has a time already
+	for (int i = 0; i < POOL_SIZE; i++)
+		check_claim(path, privkey, pubkey);
+
+	uint32_t claimed = SLOT_CLAIMED, claim_time = 1;
+	poke(path, HEADER_SIZE, &claimed, sizeof(claimed));
+	poke(path, HEADER_SIZE + 4, &claim_time, sizeof(claim_time));
+	poke(path, HEADER_SIZE + SLOT_SIZE, &claimed, sizeof(claimed));
+	assert_int_equal(pool_fill(path, pubkey, POOL_SIZE, NULL), POOL_SIZE - 1);
+	check_claim(path, privkey, pubkey);
+
+	// expired pools are not claimed from but replaced
+	int64_t created = time(NULL) - 2 * 24 * 60 * 60;
+	poke(path, CREATED_OFFSET, &created, sizeof(created));
+	assert_int_equal(pool_claim(path, pubkey, challenge, dh_shared), -1);
+	assert_int_equal(pool_fill(path, pubkey, POOL_SIZE, NULL), POOL_SIZE);
+	check_claim(path, privkey, pubkey);
+	assert_int_equal(pool_fill(path, pubkey, POOL_SIZE, NULL), 1);
+
+	// a file others can read is rejected
+	assert_int_equal(chmod(path, 0644), 0);
+	assert_int_equal(pool_claim(path, pubkey, challenge, dh_shared), -1);
+
+	// and replaced by the next fill, as is a pool for another key
+	assert_int_equal(pool_fill(path, pubkey, POOL_SIZE, NULL), POOL_SIZE);
+	check_claim(path, privkey, pubkey);
+	assert_int_equal(pool_fill(path, other, POOL_SIZE, NULL), POOL_SIZE);
+	assert_int_equal(pool_claim(path, pubkey, challenge, dh_shared), -1);
+
+	assert_int_equal(unlink(path), 0);
+	assert_int_equal(rmdir(dir), 0);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_pool),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,137 @@
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "qr.h"
+#include "qrenc.h"
+#include "utils.h"
+
+#define QUIET_SIZE 4
+#define URL "https://auth.example.com/pbotp/dev/SSSN7PBXFG6DY/root/5Cj-MDxXaXmfh0yLOSJh3CNvHJlUzvGrmrWYUW-Y1xA"
+
+static uint8_t arena_buf[65536];
+
+struct output {
+	char text[32768];
+	size_t len, lines;
+};
+
+static void collect(const char *line, void *arg)
+{
+	struct output *out = arg;
+	size_t len = strlen(line);
+
+	assert_true(out->len + len + 1 < sizeof(out->text));
+	memcpy(out->text + out->len, line, len);
+	out->text[out->len + len] = '\n';
+	out->len += len + 1;
+	out->lines++;
+}
+
+static void test_braille(void **state)
+{
+	(void) state;
+
+	struct arena arena;
+	arena_init(&arena, arena_buf, sizeof(arena_buf));
+
+	struct qrcode *qr = encode_qr(URL, &arena);
+	assert_non_null(qr);
+
+	static struct output out;
+	assert_int_equal(print_qr(qr, QR_MODE_BRAILLE, &arena, collect, &out), 0);
+
+	int size = qr->width + 2 * QUIET_SIZE;
+	assert_int_equal(out.lines, (size + 3) / 4);
+
+	// decode the dots back into modules, raised dots being light ones
+	static const int dot_x[8] = { 0, 0, 0, 1, 1, 1, 0, 1 };
+	static const int dot_y[8] = { 0, 1, 2, 0, 1, 2, 3, 3 };
+
+	const char *p = out.text;
+	for (size_t row = 0; row < out.lines; row++) {
+		p = strchr(p, 'm') + 1;
+
+		for (int col = 0; col < (size + 1) / 2; col++) {
+			assert_int_equal((uint8_t)p[0], 0xe2);
+			int cell = ((uint8_t)p[1] & 0x03) << 6 | ((uint8_t)p[2] & 0x3f);
+			p += 3;
+
+			for (int dot = 0; dot < 8; dot++) {
+				int x = 2 * col + dot_x[dot] - QUIET_SIZE;
+				int y = 4 * row + dot_y[dot] - QUIET_SIZE;
+
+				bool light = true;
+				if (x >= 0 && y >= 0 && x < qr->width && y < qr->width)
+					light = !(qr->modules[qr->width * y + x] & 1);
+
+				assert_int_equal(!!(cell & (1 << dot)), light);
+			}
+		}
+
+		p = strchr(p, '\n') + 1;
+	}
+
+	arena_wipe(&arena);
+}
+
+static void test_sizes(void **state)
+{
+	(void) state;
+
+	static const char *names[] = {
+		[QR_MODE_UTF8] = "utf8",
+		[QR_MODE_ANSI] = "ansi",
+		[QR_MODE_ASCII] = "ascii",
+		[QR_MODE_BRAILLE] = "braille",
+	};
+
+	size_t braille_len = 0, braille_lines = 0;
+
+	for (int mode = QR_MODE_BRAILLE; mode >= QR_MODE_UTF8; mode--) {
+		struct arena arena;
+		arena_init(&arena, arena_buf, sizeof(arena_buf));
+
+		struct qrcode *qr = encode_qr(URL, &arena);
+		assert_non_null(qr);
+
+		static struct output out;
+		out.len = out.lines = 0;
+		assert_int_equal(print_qr(qr, mode, &arena, collect, &out), 0);
+
+		// format_qr produces the same lines
+		char *msg = format_qr(qr, mode, "", "", &arena);
+		assert_non_null(msg);
+		assert_int_equal(strlen(msg), out.len + 1);
+		assert_memory_equal(msg + 1, out.text, out.len);
+
+		if (mode == QR_MODE_BRAILLE) {
+			braille_len = out.len;
+			braille_lines = out.lines;
+		} else {
+			assert_true(braille_len < out.len);
+			assert_true(braille_lines < out.lines);
+		}
+
+		printf("%-8s %3zu lines %6zu bytes\n", names[mode], out.lines, out.len);
+
+		arena_wipe(&arena);
+	}
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_braille),
+		cmocka_unit_test(test_sizes),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,168 @@
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "qrenc.h"
+#include "sha256.h"
+
+static struct qrcode qr;
+
+static void test_vectors(void **state)
+{
+	(void) state;
+
+	// module matrices checked against the python-qrcode reference encoder
+	struct test_vector {
+		const char *str;
+		int version;
+		uint8_t modules_sha256[SHA256_SIZE];
+	} vectors[] = {
+		{
+			"HELLO WORLD", 1,
+			{ 0x48, 0xa7, 0xd9, 0x6a, 0x72, 0x4c, 0xa2, 0x6d, 0xca, 0x6c, 0x8d, 0x7e, 0xc5, 0x5b, 0xfe, 0x97,
+			  0x6f, 0x92, 0xf0, 0x8c, 0x9c, 0xc3, 0x5d, 0x94, 0x40, 0x3a, 0x27, 0xd0, 0x66, 0x89, 0xda, 0x4a },
+		},
+		{
+			"https://auth.example.com/pbotp/dev/SSSN7PBXFG6DY/root/5Cj-MDxXaXmfh0yLOSJh3CNvHJlUzvGrmrWYUW-Y1xA", 5,
+			{ 0x9e, 0xac, 0x75, 0x23, 0x64, 0x4e, 0x22, 0x85, 0x88, 0x53, 0x7b, 0x8b, 0x15, 0x3b, 0x17, 0x26,
+			  0x7c, 0xfb, 0x28, 0x68, 0xee, 0x01, 0x76, 0x05, 0x45, 0xdd, 0xcf, 0xfb, 0x22, 0xf4, 0x12, 0x74 },
+		},
+	};
+
+	for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+		uint8_t hash[SHA256_SIZE];
+
+		assert_int_equal(qrenc_encode(&qr, vectors[i].str), 0);
+		assert_int_equal(qr.version, vectors[i].version);
+		assert_int_equal(qr.width, 17 + 4 * vectors[i].version);
+
+		sha256(hash, qr.modules, qr.width * qr.width);
+		assert_memory_equal(hash, vectors[i].modules_sha256, SHA256_SIZE);
+	}
+}
+
+static void test_capacity(void **state)
+{
+	(void) state;
+
+	// lengths on both sides of version boundaries, including the longer
+	// character count of byte segments from version 10 on
+	struct capacity {
+		char c;
+		size_t len;
+		int version;
+	} capacities[] = {
+		{ '1', 41, 1 },
+		{ '1', 42, 2 },
+		{ 'A', 25, 1 },
+		{ 'A', 26, 2 },
+		{ 'a', 17, 1 },
+		{ 'a', 18, 2 },
+		{ 'a', 230, 9 },
+		{ 'a', 231, 10 },
+		{ 'a', 425, 13 },
+		{ 'a', 426, -1 },
+	};
+
+	char str[512];
+
+	for (size_t i = 0; i < sizeof(capacities) / sizeof(capacities[0]); i++) {
+		memset(str, capacities[i].c, capacities[i].len);
+		str[capacities[i].len] = 0;
+
+		if (capacities[i].version < 0) {
+			assert_int_equal(qrenc_encode(&qr, str), -1);
+		} else {
+			assert_int_equal(qrenc_encode(&qr, str), 0);
+			assert_int_equal(qr.version, capacities[i].version);
+		}
+	}
+}
+
+static void test_segments(void **state)
+{
+	(void) state;
+
+	struct qrenc_segment segs[] = {
+		{ QRENC_MODE_BYTE, "https://", 8 },
+		{ QRENC_MODE_ALNUM, "EXAMPLE.COM", 11 },
+	};
+
+	assert_int_equal(qrenc_encode_segments(&qr, segs, 2), 0);
+	assert_int_equal(qr.version, 1);
+
+	// lowercase letters can't be put in an alphanumeric segment, nor
+	// letters in a numeric one
+	segs[1].data = "example.com";
+	assert_int_equal(qrenc_encode_segments(&qr, segs, 2), -1);
+
+	segs[1] = (struct qrenc_segment) { QRENC_MODE_NUMERIC, "0123456789A", 11 };
+	assert_int_equal(qrenc_encode_segments(&qr, segs, 2), -1);
+	segs[1].len = 10;
+	assert_int_equal(qrenc_encode_segments(&qr, segs, 2), 0);
+
+	assert_true(qrenc_is_alnum('Z'));
+	assert_true(qrenc_is_alnum(':'));
+	assert_false(qrenc_is_alnum('z'));
+	assert_false(qrenc_is_alnum('_'));
+}
+
+// lines printed in the default utf8 mode, including the quiet zone
+static int utf8_lines(int width)
+{
+	return (width + 1) / 2 + 4;
+}
+
+static void test_urls(void **state)
+{
+	(void) state;
+
+	// typical login URLs: numeric and alphanumeric runs (everything uppercase,
+	// the slashes and digits) are split off the case sensitive parts when that
+	// is shorter
+	struct url {
+		const char *str;
+		int byte_version;
+		int version;
+	} urls[] = {
+		{ "https://auth.example.com/pbotp/dev/SSSN7PBXFG6DY/root/5Cj-MDxXaXmfh0yLOSJh3CNvHJlUzvGrmrWYUW-Y1xA", 5, 5 },
+		{ "HTTPS://AUTH.EXAMPLE.COM/PBOTP/dev/SSSN7PBXFG6DY/root/5Cj-MDxXaXmfh0yLOSJh3CNvHJlUzvGrmrWYUW-Y1xA", 5, 5 },
+		{ "HTTPS://PBOTP.EXAMPLE.COM/ROUTER-X2/GW1/root/5Cj-MDxXaXmfh0yLOSJh3CNvHJlUzvGrmrWYUW-Y1xA", 5, 4 },
+		{ "https://pbotp.example.com/login/BUILD-SERVERS/build-01.lab.example.org/jenkins/5Cj-MDxXaXmfh0yLOSJh3CNvHJlUzvGrmrWYUW-Y1xA", 6, 6 },
+		// url_format=compact, with and without a group alias
+		{ "https://auth.example.com/pbotp/dev/SSSN7PBXFG6DY/root/041127147076782497953142476407891014659948021277234225654024133224789119230067", 6, 5 },
+		{ "HTTPS://AUTH.EXAMPLE.COM/PBOTP/D/SSSN7PBXFG6DY/root/041127147076782497953142476407891014659948021277234225654024133224789119230067", 6, 4 },
+	};
+
+	for (size_t i = 0; i < sizeof(urls) / sizeof(urls[0]); i++) {
+		struct qrenc_segment seg = { QRENC_MODE_BYTE, urls[i].str, strlen(urls[i].str) };
+
+		assert_int_equal(qrenc_encode_segments(&qr, &seg, 1), 0);
+		assert_int_equal(qr.version, urls[i].byte_version);
+		int byte_lines = utf8_lines(qr.width);
+
+		assert_int_equal(qrenc_encode(&qr, urls[i].str), 0);
+		assert_int_equal(qr.version, urls[i].version);
+
+		printf("%s\n    byte mode: version %d, %d lines; split: version %d, %d lines\n",
+		       urls[i].str, urls[i].byte_version, byte_lines, qr.version, utf8_lines(qr.width));
+	}
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_vectors),
+		cmocka_unit_test(test_capacity),
+		cmocka_unit_test(test_segments),
+		cmocka_unit_test(test_urls),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -7,7 +7,13 @@
 
 #include <cmocka.h>
 
+#include "cpu.h"
 #include "sha256.h"
+#include "utils.h"
+
+// the CPU features sha256_dispatch is run with before each pass, the AVX2
+// lanes are only selected without the SHA extensions
+static const unsigned int backends[] = { ~0u, CPU_AVX2, 0 };
 
 static void test_vectors(void **state)
 {
@@ -55,11 +61,15 @@ static void test_vectors(void **state)
 	};
 #undef SIZED_STR
 
-	for (size_t i = 0; vecs[i].data; i++) {
-		uint8_t out[SHA256_SIZE];
+	for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+		assert_int_equal(sha256_dispatch(cpu_features() & backends[b]), 0);
+
+		for (size_t i = 0; vecs[i].data; i++) {
+			uint8_t out[SHA256_SIZE];
 
-		sha256(out, vecs[i].data, vecs[i].data_len);
-		assert_memory_equal(vecs[i].result, out, SHA256_SIZE);
+			sha256(out, vecs[i].data, vecs[i].data_len);
+			assert_memory_equal(vecs[i].result, out, SHA256_SIZE);
+		}
 	}
 }
 
@@ -70,20 +80,98 @@ static void test_partial_feed(void **state)
 	const char *in = "db94592b6838823588e9958724b72372c2c8168cd257eb7ffa26fc756cc3727b0ef2d9acbdcafb359794a99fd611f998ff1c5234b5754c271bd47efdb61594d8";
 	size_t inlen = strlen(in);
 
-	uint8_t ref_out[SHA256_SIZE];
-	sha256(ref_out, (uint8_t*)in, strlen(in));
+	for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+		assert_int_equal(sha256_dispatch(cpu_features() & backends[b]), 0);
+
+		uint8_t ref_out[SHA256_SIZE];
+		sha256(ref_out, (uint8_t*)in, strlen(in));
+
+		struct sha256_state s;
+		for (size_t i = 0; i < inlen; i++) {
+			uint8_t out[SHA256_SIZE];
+
+			sha256_init(&s);
+			sha256_process(&s, (uint8_t*)&in[0], i);
+			sha256_process(&s, (uint8_t*)&in[i], inlen - i);
+			sha256_finish(&s, out);
+
+			assert_memory_equal(out, ref_out, SHA256_SIZE);
+		}
+	}
+}
+
+static void test_backends_agree(void **state)
+{
+	(void) state;
+
+	uint8_t in[300];
+	for (size_t i = 0; i < sizeof(in); i++)
+		in[i] = (uint8_t)(i * 131 + 7);
+
+	// all lengths up to several blocks, covering every padding case
+	for (size_t len = 0; len <= sizeof(in); len++) {
+		uint8_t native[SHA256_SIZE], portable[SHA256_SIZE];
+
+		assert_int_equal(sha256_dispatch(cpu_features()), 0);
+		sha256(native, in, len);
+		assert_int_equal(sha256_dispatch(0), 0);
+		sha256(portable, in, len);
 
-	struct sha256_state s;
-	for (size_t i = 0; i < inlen; i++) {
-		uint8_t out[SHA256_SIZE];
+		assert_memory_equal(native, portable, SHA256_SIZE);
+	}
+}
+
+static void test_batch(void **state)
+{
+	(void) state;
+
+#define COUNT (2 * SHA256_LANES + 3)
+	uint8_t in[300];
+	for (size_t i = 0; i < sizeof(in); i++)
+		in[i] = (uint8_t)(i * 131 + 7);
+
+	for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); b++) {
+		assert_int_equal(sha256_dispatch(cpu_features() & backends[b]), 0);
+
+		// lanes start with different amounts of buffered data and take
+		// different numbers of blocks
+		for (size_t split = 0; split < 70; split += 23) {
+			struct sha256_state md[COUNT];
+			const unsigned char *p[COUNT];
+			size_t len[COUNT];
+			uint8_t out[COUNT][SHA256_SIZE];
+
+			for (size_t i = 0; i < COUNT; i++) {
+				size_t total = (i * 37 + split) % sizeof(in);
+
+				sha256_init(&md[i]);
+				sha256_process(&md[i], in, MIN(split, total));
+				p[i] = in + MIN(split, total);
+				len[i] = total - MIN(split, total);
+			}
 
-		sha256_init(&s);
-		sha256_process(&s, (uint8_t*)&in[0], i);
-		sha256_process(&s, (uint8_t*)&in[i], inlen - i);
-		sha256_finish(&s, out);
+			sha256_process_batch(md, p, len, COUNT);
+			sha256_finish_batch(md, out, COUNT);
 
-		assert_memory_equal(out, ref_out, SHA256_SIZE);
+			for (size_t i = 0; i < COUNT; i++) {
+				uint8_t expected[SHA256_SIZE];
+
+				sha256(expected, in, (i * 37 + split) % sizeof(in));
+				assert_memory_equal(out[i], expected, SHA256_SIZE);
+			}
+		}
 	}
+#undef COUNT
+}
+
+static void test_dispatch(void **state)
+{
+	(void) state;
+
+	// both the implementation selected for this CPU and the portable one
+	// pass their self-test
+	assert_int_equal(sha256_dispatch(cpu_features()), 0);
+	assert_int_equal(sha256_dispatch(0), 0);
 }
 
 int main(int argc, char **argv)
@@ -93,7 +181,10 @@ int main(int argc, char **argv)
 
 	const struct CMUnitTest tests[] = {
 		cmocka_unit_test(test_vectors),
-		cmocka_unit_test(test_partial_feed)
+		cmocka_unit_test(test_partial_feed),
+		cmocka_unit_test(test_backends_agree),
+		cmocka_unit_test(test_batch),
+		cmocka_unit_test(test_dispatch),
 	};
 
 	return cmocka_run_group_tests_name("sha256", tests, NULL, NULL);
@@ -0,0 +1,379 @@
+#include <stdlib.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "cpu.h"
+#include "tweetnacl.h"
+#include "utils.h"
+#include "x25519.h"
+
+typedef int (*scalarmult_fn)(uint8_t *q, const uint8_t *n, const uint8_t *p);
+
+static const struct {
+	const char *name;
+	scalarmult_fn fn;
+	unsigned int cpu;
+} backends[] = {
+	{ "ref", crypto_scalarmult_ref, 0 },
+#ifdef HAVE_FE51
+	{ "fe51", crypto_scalarmult_fe51, 0 },
+#endif
+#ifdef HAVE_FE25
+	{ "fe25", crypto_scalarmult_fe25, 0 },
+#endif
+#ifdef HAVE_MULX
+	{ "mulx", crypto_scalarmult_mulx, CPU_BMI2_ADX },
+#endif
+};
+
+static bool backend_usable(size_t b)
+{
+	return (cpu_features() & backends[b].cpu) == backends[b].cpu;
+}
+
+static void test_rfc7748(void **state)
+{
+	(void) state;
+
+	// RFC7748, Section 5.2
+
+	static const struct {
+		uint8_t scalar[32], u[32], result[32];
+	} vecs[] = {
+		{
+			{
+				0xa5, 0x46, 0xe3, 0x6b, 0xf0, 0x52, 0x7c, 0x9d, 0x3b, 0x16, 0x15, 0x4b, 0x82, 0x46, 0x5e, 0xdd,
+				0x62, 0x14, 0x4c, 0x0a, 0xc1, 0xfc, 0x5a, 0x18, 0x50, 0x6a, 0x22, 0x44, 0xba, 0x44, 0x9a, 0xc4
+			},
+			{
+				0xe6, 0xdb, 0x68, 0x67, 0x58, 0x30, 0x30, 0xdb, 0x35, 0x94, 0xc1, 0xa4, 0x24, 0xb1, 0x5f, 0x7c,
+				0x72, 0x66, 0x24, 0xec, 0x26, 0xb3, 0x35, 0x3b, 0x10, 0xa9, 0x03, 0xa6, 0xd0, 0xab, 0x1c, 0x4c
+			},
+			{
+				0xc3, 0xda, 0x55, 0x37, 0x9d, 0xe9, 0xc6, 0x90, 0x8e, 0x94, 0xea, 0x4d, 0xf2, 0x8d, 0x08, 0x4f,
+				0x32, 0xec, 0xcf, 0x03, 0x49, 0x1c, 0x71, 0xf7, 0x54, 0xb4, 0x07, 0x55, 0x77, 0xa2, 0x85, 0x52
+			}
+		},
+		{
+			{
+				0x4b, 0x66, 0xe9, 0xd4, 0xd1, 0xb4, 0x67, 0x3c, 0x5a, 0xd2, 0x26, 0x91, 0x95, 0x7d, 0x6a, 0xf5,
+				0xc1, 0x1b, 0x64, 0x21, 0xe0, 0xea, 0x01, 0xd4, 0x2c, 0xa4, 0x16, 0x9e, 0x79, 0x18, 0xba, 0x0d
+			},
+			{
+				0xe5, 0x21, 0x0f, 0x12, 0x78, 0x68, 0x11, 0xd3, 0xf4, 0xb7, 0x95, 0x9d, 0x05, 0x38, 0xae, 0x2c,
+				0x31, 0xdb, 0xe7, 0x10, 0x6f, 0xc0, 0x3c, 0x3e, 0xfc, 0x4c, 0xd5, 0x49, 0xc7, 0x15, 0xa4, 0x93
+			},
+			{
+				0x95, 0xcb, 0xde, 0x94, 0x76, 0xe8, 0x90, 0x7d, 0x7a, 0xad, 0xe4, 0x5c, 0xb4, 0xb8, 0x73, 0xf8,
+				0x8b, 0x59, 0x5a, 0x68, 0x79, 0x9f, 0xa1, 0x52, 0xe6, 0xf8, 0xf7, 0x64, 0x7a, 0xac, 0x79, 0x57
+			}
+		},
+	};
+
+	for (size_t b = 0; b < ARRAY_SIZE(backends); b++) {
+		if (!backend_usable(b))
+			continue;
+
+		for (size_t i = 0; i < ARRAY_SIZE(vecs); i++) {
+			uint8_t out[32];
+
+			backends[b].fn(out, vecs[i].scalar, vecs[i].u);
+			assert_memory_equal(out, vecs[i].result, 32);
+		}
+	}
+}
+
+static void test_rfc7748_iterated(void **state)
+{
+	(void) state;
+
+	// RFC7748, Section 5.2, after 1 and 1000 iterations, using the
+	// backend selected for this CPU
+
+	static const uint8_t after_1[32] = {
+		0x42, 0x2c, 0x8e, 0x7a, 0x62, 0x27, 0xd7, 0xbc, 0xa1, 0x35, 0x0b, 0x3e, 0x2b, 0xb7, 0x27, 0x9f,
+		0x78, 0x97, 0xb8, 0x7b, 0xb6, 0x85, 0x4b, 0x78, 0x3c, 0x60, 0xe8, 0x03, 0x11, 0xae, 0x30, 0x79
+	};
+
+	static const uint8_t after_1000[32] = {
+		0x68, 0x4c, 0xf5, 0x9b, 0xa8, 0x33, 0x09, 0x55, 0x28, 0x00, 0xef, 0x56, 0x6f, 0x2f, 0x4d, 0x3c,
+		0x1c, 0x38, 0x87, 0xc4, 0x93, 0x60, 0xe3, 0x87, 0x5f, 0x2e, 0xb9, 0x4d, 0x99, 0x53, 0x2c, 0x51
+	};
+
+	uint8_t k[32] = {9}, u[32] = {9}, out[32];
+
+	assert_int_equal(x25519_dispatch(cpu_features()), 0);
+
+	for (int i = 1; i <= 1000; i++) {
+		crypto_scalarmult(out, k, u);
+		memcpy(u, k, 32);
+		memcpy(k, out, 32);
+
+		if (i == 1)
+			assert_memory_equal(k, after_1, 32);
+	}
+
+	assert_memory_equal(k, after_1000, 32);
+}
+
+static void test_base(void **state)
+{
+	(void) state;
+
+	// RFC7748, Section 6.1
+
+	static const uint8_t alice_priv[32] = {
+		0x77, 0x07, 0x6d, 0x0a, 0x73, 0x18, 0xa5, 0x7d, 0x3c, 0x16, 0xc1, 0x72, 0x51, 0xb2, 0x66, 0x45,
+		0xdf, 0x4c, 0x2f, 0x87, 0xeb, 0xc0, 0x99, 0x2a, 0xb1, 0x77, 0xfb, 0xa5, 0x1d, 0xb9, 0x2c, 0x2a
+	};
+
+	static const uint8_t alice_pub[32] = {
+		0x85, 0x20, 0xf0, 0x09, 0x89, 0x30, 0xa7, 0x54, 0x74, 0x8b, 0x7d, 0xdc, 0xb4, 0x3e, 0xf7, 0x5a,
+		0x0d, 0xbf, 0x3a, 0x0d, 0x26, 0x38, 0x1a, 0xf4, 0xeb, 0xa4, 0xa9, 0x8e, 0xaa, 0x9b, 0x4e, 0x6a
+	};
+
+	uint8_t out[32];
+	crypto_scalarmult_base(out, alice_priv);
+	assert_memory_equal(out, alice_pub, 32);
+
+	// the fixed-base path must match a generic ladder on u = 9 for
+	// arbitrary scalars, chain outputs into the next scalar
+
+	static const uint8_t nine[32] = {9};
+	uint8_t n[32];
+	memcpy(n, alice_priv, 32);
+
+	for (int i = 0; i < 32; i++) {
+		uint8_t ref[32];
+
+		crypto_scalarmult_ref(ref, n, nine);
+		crypto_scalarmult_base(out, n);
+		assert_memory_equal(out, ref, 32);
+
+		memcpy(n, out, 32);
+	}
+}
+
+static void test_backends_agree(void **state)
+{
+	(void) state;
+
+	// chain the output of each round into the inputs of the next one, this
+	// also covers non-canonical points since the top bit of the point is
+	// set from the scalar
+
+	uint8_t n[32] = {1}, p[32] = {9};
+
+	for (int i = 0; i < 32; i++) {
+		uint8_t ref[32];
+
+		p[31] ^= n[0] & 0x80;
+		crypto_scalarmult_ref(ref, n, p);
+
+		for (size_t b = 1; b < ARRAY_SIZE(backends); b++) {
+			uint8_t out[32];
+
+			if (!backend_usable(b))
+				continue;
+
+			backends[b].fn(out, n, p);
+			assert_memory_equal(out, ref, 32);
+		}
+
+		memcpy(n, p, 32);
+		memcpy(p, ref, 32);
+	}
+}
+
+static void test_invert(void **state)
+{
+	(void) state;
+
+	// 0, 1, 2, p - 1, p - 2 and chained results
+
+	uint8_t a[32] = {0}, fermat[32], safegcd[32];
+
+	for (int i = 0; i < 64; i++) {
+		if (i < 3) {
+			a[0] = i;
+		} else if (i < 5) {
+			memset(a, 0xff, 32);
+			a[0] = 0xec - (i - 3);
+			a[31] = 0x7f;
+		}
+
+		x25519_invert_fermat(fermat, a);
+		x25519_invert_safegcd(safegcd, a);
+		assert_memory_equal(safegcd, fermat, 32);
+
+		if (i >= 4) {
+			memcpy(a, safegcd, 32);
+			a[i % 32] ^= i;
+			a[31] &= 0x3f;
+		}
+	}
+}
+
+static void test_table(void **state)
+{
+	(void) state;
+
+	if (CRYPTO_SCALARMULT_TABLE_BYTES == 0)
+		skip();
+
+	uint8_t *table = malloc(CRYPTO_SCALARMULT_TABLE_BYTES);
+	assert_non_null(table);
+
+	// u = 2 is on the twist, u = -1 has no Edwards equivalent
+	static const uint8_t twist[32] = {2};
+	static const uint8_t minus_one[32] = {
+		0xec, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+		0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f
+	};
+
+	assert_int_equal(crypto_scalarmult_table_init(table, twist), -1);
+	assert_int_equal(crypto_scalarmult_table_init(table, minus_one), -1);
+
+	// low order points (u = 0, 1) and points from chained outputs
+
+	uint8_t n[32] = {1}, p[32] = {0};
+
+	for (int i = 0; i < 16; i++) {
+		uint8_t ref[32], out[32];
+
+		if (i == 1)
+			p[0] = 1;
+		else if (i == 2)
+			p[0] = 9;
+
+		crypto_scalarmult_ref(ref, n, p);
+
+		assert_int_equal(crypto_scalarmult_table_init(table, p), 0);
+		crypto_scalarmult_table(out, n, table);
+		assert_memory_equal(out, ref, 32);
+
+		memcpy(n, p, 32);
+		n[0] ^= i;
+		if (i >= 2)
+			memcpy(p, ref, 32);
+	}
+
+	free(table);
+}
+
+static void test_base_pair(void **state)
+{
+	(void) state;
+
+	static const uint8_t nine[32] = {9};
+
+	uint8_t *table = NULL;
+	if (CRYPTO_SCALARMULT_TABLE_BYTES != 0) {
+		table = malloc(CRYPTO_SCALARMULT_TABLE_BYTES);
+		assert_non_null(table);
+	}
+
+	// u = 0 makes the second result zero, which must not affect the first
+
+	uint8_t n[32] = {1}, p[32] = {0};
+
+	for (int i = 0; i < 16; i++) {
+		uint8_t ref_base[32], ref[32], out_base[32], out[32];
+
+		crypto_scalarmult_ref(ref_base, n, nine);
+		crypto_scalarmult_ref(ref, n, p);
+
+		crypto_scalarmult_base_pair(out_base, out, n, p, NULL);
+		assert_memory_equal(out_base, ref_base, 32);
+		assert_memory_equal(out, ref, 32);
+
+		if (table && crypto_scalarmult_table_init(table, p) == 0) {
+			crypto_scalarmult_base_pair(out_base, out, n, p, table);
+			assert_memory_equal(out_base, ref_base, 32);
+			assert_memory_equal(out, ref, 32);
+		}
+
+		memcpy(n, ref_base, 32);
+		memcpy(p, ref, 32);
+		p[0] ^= i;
+	}
+
+	free(table);
+}
+
+static void check_batch(int (*fn)(uint8_t *q, const uint8_t *n, const uint8_t *p, size_t count))
+{
+	// more points than any backend normalizes at once and a count that is
+	// not a multiple of four, with low order points in between whose zero
+	// denominators must not affect the others
+
+	enum { COUNT = 23 };
+	uint8_t n[32] = {1}, p[COUNT * 32], q[COUNT * 32];
+
+	for (int round = 0; round < 4; round++) {
+		for (int i = 0; i < COUNT; i++) {
+			memset(&p[32 * i], 0, 32);
+
+			if (i % 7 == 3) {
+				p[32 * i] = round & 1;
+				continue;
+			}
+
+			p[32 * i] = 9;
+			crypto_scalarmult_ref(&p[32 * i], n, &p[32 * i]);
+			p[32 * i + 31] ^= (round & 1) << 7;
+			n[1] ^= i;
+		}
+
+		fn(q, n, p, COUNT);
+
+		for (int i = 0; i < COUNT; i++) {
+			uint8_t ref[32];
+
+			crypto_scalarmult_ref(ref, n, &p[32 * i]);
+			assert_memory_equal(&q[32 * i], ref, 32);
+		}
+
+		memcpy(n, &q[32], 32);
+	}
+}
+
+static void test_batch(void **state)
+{
+	(void) state;
+
+	// with and without the CPU specific backends
+	assert_int_equal(x25519_dispatch(cpu_features()), 0);
+	check_batch(crypto_scalarmult_batch);
+	assert_int_equal(x25519_dispatch(0), 0);
+	check_batch(crypto_scalarmult_batch);
+
+#ifdef HAVE_FE51
+	check_batch(crypto_scalarmult_batch_fe51);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+	(void) argc;
+	(void) argv;
+
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_rfc7748),
+		cmocka_unit_test(test_rfc7748_iterated),
+		cmocka_unit_test(test_base),
+		cmocka_unit_test(test_backends_agree),
+		cmocka_unit_test(test_invert),
+		cmocka_unit_test(test_table),
+		cmocka_unit_test(test_base_pair),
+		cmocka_unit_test(test_batch),
+	};
+
+	return cmocka_run_group_tests_name("x25519", tests, NULL, NULL);
+}
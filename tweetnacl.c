@@ -1,13 +1,16 @@
-// - minimized to only contain crypto_scalarmult / crypto_scalarmult_base and
-//   dependencies
+// - minimized to only contain crypto_scalarmult and dependencies
 // - UB fixed in car25519, see [1]
+// - crypto_scalarmult renamed to crypto_scalarmult_ref, it serves as the
+//   portable backend behind crypto_scalarmult in x25519.c
+// - inv25519 uses x25519_invert_safegcd if built with HAVE_SAFEGCD, the
+//   original version is kept as x25519_invert_fermat
 //
 // otherwise identical to TweetNaCl[2] version 20140427
 //
 // [1] Schwabe, Peter, et al. "A Coq proof of the correctness of X25519 in TweetNaCl." IACR Cryptol. ePrint Arch. 2021 (2021): 428.
 // [2] https://tweetnacl.cr.yp.to/
 
-#include "tweetnacl.h"
+#include "x25519.h"
 #define FOR(i,n) for (i = 0;i < n;++i)
 #define sv static void
 
@@ -17,8 +20,6 @@ typedef unsigned long long u64;
 typedef long long i64;
 typedef i64 gf[16];
 
-static const u8
-  _9[32] = {9};
 static const gf
   _121665 = {0xDB41,1};
 
@@ -101,7 +102,7 @@ sv S(gf o,const gf a)
   M(o,a,a);
 }
 
-sv inv25519(gf o,const gf i)
+sv inv25519_fermat(gf o,const gf i)
 {
   gf c;
   int a;
@@ -113,7 +114,27 @@ sv inv25519(gf o,const gf i)
   FOR(a,16) o[a]=c[a];
 }
 
-int crypto_scalarmult(u8 *q,const u8 *n,const u8 *p)
+void x25519_invert_fermat(u8 *o,const u8 *i)
+{
+  gf c;
+  unpack25519(c,i);
+  inv25519_fermat(c,c);
+  pack25519(o,c);
+}
+
+sv inv25519(gf o,const gf i)
+{
+#ifdef HAVE_SAFEGCD
+  u8 b[32];
+  pack25519(b,i);
+  x25519_invert_safegcd(b,b);
+  unpack25519(o,b);
+#else
+  inv25519_fermat(o,i);
+#endif
+}
+
+int crypto_scalarmult_ref(u8 *q,const u8 *n,const u8 *p)
 {
   u8 z[32];
   i64 x[80],r,i;
@@ -163,8 +184,3 @@ int crypto_scalarmult(u8 *q,const u8 *n,const u8 *p)
   pack25519(q,x+16);
   return 0;
 }
-
-int crypto_scalarmult_base(u8 *q,const u8 *n)
-{
-  return crypto_scalarmult(q,n,_9);
-}
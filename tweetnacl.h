@@ -1,4 +1,29 @@
 #pragma once
 
+#include <stddef.h>
+
 int crypto_scalarmult(unsigned char *q,const unsigned char *n,const unsigned char *p);
 int crypto_scalarmult_base(unsigned char *q,const unsigned char *n);
+
+// q[i] = n * p[i] for count points, q and p hold 32 * count bytes. The results
+// share a single field inversion, so this is faster than count calls to
+// crypto_scalarmult.
+int crypto_scalarmult_batch(unsigned char *q, const unsigned char *n, const unsigned char *p, size_t count);
+
+// Multiplication with a fixed point via a table of precomputed multiples.
+// crypto_scalarmult_table_init fails if the point is not suitable (or no
+// backend supports tables, CRYPTO_SCALARMULT_TABLE_BYTES is 0 then), in which
+// case crypto_scalarmult needs to be used.
+#ifdef HAVE_FE51
+#define CRYPTO_SCALARMULT_TABLE_BYTES (32 * 8 * 3 * 5 * 8)
+#else
+#define CRYPTO_SCALARMULT_TABLE_BYTES 0
+#endif
+
+int crypto_scalarmult_table_init(void *table, const unsigned char *p);
+int crypto_scalarmult_table(unsigned char *q, const unsigned char *n, const void *table);
+
+// q_base = n * 9 and q = n * p (using p_table if not NULL), sharing work
+// between both multiplications
+int crypto_scalarmult_base_pair(unsigned char *q_base, unsigned char *q,
+                                const unsigned char *n, const unsigned char *p, const void *p_table);
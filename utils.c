@@ -4,7 +4,9 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include <limits.h>
 #include <errno.h>
+#include <sys/mman.h>
 #include <sys/random.h>
 
 #include "utils.h"
@@ -47,17 +49,17 @@ bool streq_isgraph(const char *a, const char *b)
 	}
 }
 
-char *join(const char **data, char c)
+ssize_t join(char *out, size_t size, const char **data, char c)
 {
+	// the elements and a separator (or the terminating NUL) after each
 	size_t len = 0;
 	for (const char **elem = data; *elem; elem++) {
 		len += strlen(*elem);
 		len++;
 	}
 
-	char *out = malloc(len + 1);
-	if (!out)
-		return NULL;
+	if (len == 0 || len > size || len > SSIZE_MAX)
+		return -1;
 
 	char *p = out;
 	for (const char **elem = data; *elem; elem++) {
@@ -67,7 +69,7 @@ char *join(const char **data, char c)
 
 	*(p-1) = 0;
 
-	return out;
+	return len - 1;
 }
 
 void wipe(void *p, size_t size)
@@ -75,11 +77,50 @@ void wipe(void *p, size_t size)
 	volatile uint8_t *p8 = (volatile uint8_t *)p;
 
 	for (size_t i = 0; i < size; i++)
-		*p8 = 0;
+		p8[i] = 0;
 
 	asm volatile ("" ::: "memory");
 }
 
+void arena_init(struct arena *arena, void *buf, size_t size)
+{
+	arena->buf = buf;
+	arena->size = size;
+	arena->used = 0;
+
+	// keep secrets out of swap if the limits allow it
+	arena->locked = mlock(buf, size) == 0;
+}
+
+void *arena_alloc(struct arena *arena, size_t size)
+{
+	const size_t align = _Alignof(max_align_t);
+	size_t start = (arena->used + align - 1) & ~(align - 1);
+
+	if (start > arena->size || size > arena->size - start) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	arena->used = start + size;
+
+	uint8_t *p = arena->buf + start;
+	memset(p, 0, size);
+
+	return p;
+}
+
+void arena_wipe(struct arena *arena)
+{
+	wipe(arena->buf, arena->used);
+	arena->used = 0;
+
+	if (arena->locked)
+		munlock(arena->buf, arena->size);
+
+	arena->locked = false;
+}
+
 void free_indirect(void *p)
 {
 	free(*(void**)p);
@@ -14,7 +14,10 @@ ssize_t xsnprintf(char *str, size_t size, const char *fmt, ...);
 #define strneq(a, b, n) (strncmp((a), (b), (n)) == 0)
 
 bool streq_isgraph(const char *a, const char *b);
-char *join(const char **data, char c);
+
+// joins the NULL terminated data with c into out, returns the length or -1 if
+// out is too small
+ssize_t join(char *out, size_t size, const char **data, char c);
 
 static inline char *startswith(const char *a, const char *b)
 {
@@ -32,6 +35,19 @@ void wipe(void *p, size_t size);
 
 int randombytes(uint8_t *out, size_t len);
 
+// bump allocator over a caller-provided buffer (locked in memory if
+// possible), for everything one authentication needs. Allocations are zeroed
+// and only freed all at once by arena_wipe, which also wipes them.
+struct arena {
+	uint8_t *buf;
+	size_t size, used;
+	bool locked;
+};
+
+void arena_init(struct arena *arena, void *buf, size_t size);
+void *arena_alloc(struct arena *arena, size_t size);
+void arena_wipe(struct arena *arena);
+
 int memcmp_ctime(const void *x, const void *y, size_t n);
 
 static inline uint32_t unp32le(const uint8_t *data) {
@@ -1,2058 +1,2087 @@
 #pragma once
 
+#include <stdint.h>
+
 // BIP39 wordlist
+//
+// Stored as fixed-size rows and a length table instead of an array of
+// pointers, so that the tables are read-only data that needs no relocations
+// when the module is loaded, and formatting a phrase needs no strlen.
 
 #define BITS_PER_WORD 11
 #define WORD_LEN_MAX 8
 
-const char *wordlist[1 << BITS_PER_WORD] = {
-	// word 0 is at line 10
-	"abandon",
-	"ability",
-	"able",
-	"about",
-	"above",
-	"absent",
-	"absorb",
-	"abstract",
-	"absurd",
-	"abuse",
-	"access",
-	"accident",
-	"account",
-	"accuse",
-	"achieve",
-	"acid",
-	"acoustic",
-	"acquire",
-	"across",
-	"act",
-	"action",
-	"actor",
-	"actress",
-	"actual",
-	"adapt",
-	"add",
-	"addict",
-	"address",
-	"adjust",
-	"admit",
-	"adult",
-	"advance",
-	"advice",
-	"aerobic",
-	"affair",
-	"afford",
-	"afraid",
-	"again",
-	"age",
-	"agent",
-	"agree",
-	"ahead",
-	"aim",
-	"air",
-	"airport",
-	"aisle",
-	"alarm",
-	"album",
-	"alcohol",
-	"alert",
-	"alien",
-	"all",
-	"alley",
-	"allow",
-	"almost",
-	"alone",
-	"alpha",
-	"already",
-	"also",
-	"alter",
-	"always",
-	"amateur",
-	"amazing",
-	"among",
-	"amount",
-	"amused",
-	"analyst",
-	"anchor",
-	"ancient",
-	"anger",
-	"angle",
-	"angry",
-	"animal",
-	"ankle",
-	"announce",
-	"annual",
-	"another",
-	"answer",
-	"antenna",
-	"antique",
-	"anxiety",
-	"any",
-	"apart",
-	"apology",
-	"appear",
-	"apple",
-	"approve",
-	"april",
-	"arch",
-	"arctic",
-	"area",
-	"arena",
-	"argue",
-	"arm",
-	"armed",
-	"armor",
-	"army",
-	"around",
-	"arrange",
-	"arrest",
-	"arrive",
-	"arrow",
-	"art",
-	"artefact",
-	"artist",
-	"artwork",
-	"ask",
-	"aspect",
-	"assault",
-	"asset",
-	"assist",
-	"assume",
-	"asthma",
-	"athlete",
-	"atom",
-	"attack",
-	"attend",
-	"attitude",
-	"attract",
-	"auction",
-	"audit",
-	"august",
-	"aunt",
-	"author",
-	"auto",
-	"autumn",
-	"average",
-	"avocado",
-	"avoid",
-	"awake",
-	"aware",
-	"away",
-	"awesome",
-	"awful",
-	"awkward",
-	"axis",
-	"baby",
-	"bachelor",
-	"bacon",
-	"badge",
-	"bag",
-	"balance",
-	"balcony",
-	"ball",
-	"bamboo",
-	"banana",
-	"banner",
-	"bar",
-	"barely",
-	"bargain",
-	"barrel",
-	"base",
-	"basic",
-	"basket",
-	"battle",
-	"beach",
-	"bean",
-	"beauty",
-	"because",
-	"become",
-	"beef",
-	"before",
-	"begin",
-	"behave",
-	"behind",
-	"believe",
-	"below",
-	"belt",
-	"bench",
-	"benefit",
-	"best",
-	"betray",
-	"better",
-	"between",
-	"beyond",
-	"bicycle",
-	"bid",
-	"bike",
-	"bind",
-	"biology",
-	"bird",
-	"birth",
-	"bitter",
-	"black",
-	"blade",
-	"blame",
-	"blanket",
-	"blast",
-	"bleak",
-	"bless",
-	"blind",
-	"blood",
-	"blossom",
-	"blouse",
-	"blue",
-	"blur",
-	"blush",
-	"board",
-	"boat",
-	"body",
-	"boil",
-	"bomb",
-	"bone",
-	"bonus",
-	"book",
-	"boost",
-	"border",
-	"boring",
-	"borrow",
-	"boss",
-	"bottom",
-	"bounce",
-	"box",
-	"boy",
-	"bracket",
-	"brain",
-	"brand",
-	"brass",
-	"brave",
-	"bread",
-	"breeze",
-	"brick",
-	"bridge",
-	"brief",
-	"bright",
-	"bring",
-	"brisk",
-	"broccoli",
-	"broken",
-	"bronze",
-	"broom",
-	"brother",
-	"brown",
-	"brush",
-	"bubble",
-	"buddy",
-	"budget",
-	"buffalo",
-	"build",
-	"bulb",
-	"bulk",
-	"bullet",
-	"bundle",
-	"bunker",
-	"burden",
-	"burger",
-	"burst",
-	"bus",
-	"business",
-	"busy",
-	"butter",
-	"buyer",
-	"buzz",
-	"cabbage",
-	"cabin",
-	"cable",
-	"cactus",
-	"cage",
-	"cake",
-	"call",
-	"calm",
-	"camera",
-	"camp",
-	"can",
-	"canal",
-	"cancel",
-	"candy",
-	"cannon",
-	"canoe",
-	"canvas",
-	"canyon",
-	"capable",
-	"capital",
-	"captain",
-	"car",
-	"carbon",
-	"card",
-	"cargo",
-	"carpet",
-	"carry",
-	"cart",
-	"case",
-	"cash",
-	"casino",
-	"castle",
-	"casual",
-	"cat",
-	"catalog",
-	"catch",
-	"category",
-	"cattle",
-	"caught",
-	"cause",
-	"caution",
-	"cave",
-	"ceiling",
-	"celery",
-	"cement",
-	"census",
-	"century",
-	"cereal",
-	"certain",
-	"chair",
-	"chalk",
-	"champion",
-	"change",
-	"chaos",
-	"chapter",
-	"charge",
-	"chase",
-	"chat",
-	"cheap",
-	"check",
-	"cheese",
-	"chef",
-	"cherry",
-	"chest",
-	"chicken",
-	"chief",
-	"child",
-	"chimney",
-	"choice",
-	"choose",
-	"chronic",
-	"chuckle",
-	"chunk",
-	"churn",
-	"cigar",
-	"cinnamon",
-	"circle",
-	"citizen",
-	"city",
-	"civil",
-	"claim",
-	"clap",
-	"clarify",
-	"claw",
-	"clay",
-	"clean",
-	"clerk",
-	"clever",
-	"click",
-	"client",
-	"cliff",
-	"climb",
-	"clinic",
-	"clip",
-	"clock",
-	"clog",
-	"close",
-	"cloth",
-	"cloud",
-	"clown",
-	"club",
-	"clump",
-	"cluster",
-	"clutch",
-	"coach",
-	"coast",
-	"coconut",
-	"code",
-	"coffee",
-	"coil",
-	"coin",
-	"collect",
-	"color",
-	"column",
-	"combine",
-	"come",
-	"comfort",
-	"comic",
-	"common",
-	"company",
-	"concert",
-	"conduct",
-	"confirm",
-	"congress",
-	"connect",
-	"consider",
-	"control",
-	"convince",
-	"cook",
-	"cool",
-	"copper",
-	"copy",
-	"coral",
-	"core",
-	"corn",
-	"correct",
-	"cost",
-	"cotton",
-	"couch",
-	"country",
-	"couple",
-	"course",
-	"cousin",
-	"cover",
-	"coyote",
-	"crack",
-	"cradle",
-	"craft",
-	"cram",
-	"crane",
-	"crash",
-	"crater",
-	"crawl",
-	"crazy",
-	"cream",
-	"credit",
-	"creek",
-	"crew",
-	"cricket",
-	"crime",
-	"crisp",
-	"critic",
-	"crop",
-	"cross",
-	"crouch",
-	"crowd",
-	"crucial",
-	"cruel",
-	"cruise",
-	"crumble",
-	"crunch",
-	"crush",
-	"cry",
-	"crystal",
-	"cube",
-	"culture",
-	"cup",
-	"cupboard",
-	"curious",
-	"current",
-	"curtain",
-	"curve",
-	"cushion",
-	"custom",
-	"cute",
-	"cycle",
-	"dad",
-	"damage",
-	"damp",
-	"dance",
-	"danger",
-	"daring",
-	"dash",
-	"daughter",
-	"dawn",
-	"day",
-	"deal",
-	"debate",
-	"debris",
-	"decade",
-	"december",
-	"decide",
-	"decline",
-	"decorate",
-	"decrease",
-	"deer",
-	"defense",
-	"define",
-	"defy",
-	"degree",
-	"delay",
-	"deliver",
-	"demand",
-	"demise",
-	"denial",
-	"dentist",
-	"deny",
-	"depart",
-	"depend",
-	"deposit",
-	"depth",
-	"deputy",
-	"derive",
-	"describe",
-	"desert",
-	"design",
-	"desk",
-	"despair",
-	"destroy",
-	"detail",
-	"detect",
-	"develop",
-	"device",
-	"devote",
-	"diagram",
-	"dial",
-	"diamond",
-	"diary",
-	"dice",
-	"diesel",
-	"diet",
-	"differ",
-	"digital",
-	"dignity",
-	"dilemma",
-	"dinner",
-	"dinosaur",
-	"direct",
-	"dirt",
-	"disagree",
-	"discover",
-	"disease",
-	"dish",
-	"dismiss",
-	"disorder",
-	"display",
-	"distance",
-	"divert",
-	"divide",
-	"divorce",
-	"dizzy",
-	"doctor",
-	"document",
-	"dog",
-	"doll",
-	"dolphin",
-	"domain",
-	"donate",
-	"donkey",
-	"donor",
-	"door",
-	"dose",
-	"double",
-	"dove",
-	"draft",
-	"dragon",
-	"drama",
-	"drastic",
-	"draw",
-	"dream",
-	"dress",
-	"drift",
-	"drill",
-	"drink",
-	"drip",
-	"drive",
-	"drop",
-	"drum",
-	"dry",
-	"duck",
-	"dumb",
-	"dune",
-	"during",
-	"dust",
-	"dutch",
-	"duty",
-	"dwarf",
-	"dynamic",
-	"eager",
-	"eagle",
-	"early",
-	"earn",
-	"earth",
-	"easily",
-	"east",
-	"easy",
-	"echo",
-	"ecology",
-	"economy",
-	"edge",
-	"edit",
-	"educate",
-	"effort",
-	"egg",
-	"eight",
-	"either",
-	"elbow",
-	"elder",
-	"electric",
-	"elegant",
-	"element",
-	"elephant",
-	"elevator",
-	"elite",
-	"else",
-	"embark",
-	"embody",
-	"embrace",
-	"emerge",
-	"emotion",
-	"employ",
-	"empower",
-	"empty",
-	"enable",
-	"enact",
-	"end",
-	"endless",
-	"endorse",
-	"enemy",
-	"energy",
-	"enforce",
-	"engage",
-	"engine",
-	"enhance",
-	"enjoy",
-	"enlist",
-	"enough",
-	"enrich",
-	"enroll",
-	"ensure",
-	"enter",
-	"entire",
-	"entry",
-	"envelope",
-	"episode",
-	"equal",
-	"equip",
-	"era",
-	"erase",
-	"erode",
-	"erosion",
-	"error",
-	"erupt",
-	"escape",
-	"essay",
-	"essence",
-	"estate",
-	"eternal",
-	"ethics",
-	"evidence",
-	"evil",
-	"evoke",
-	"evolve",
-	"exact",
-	"example",
-	"excess",
-	"exchange",
-	"excite",
-	"exclude",
-	"excuse",
-	"execute",
-	"exercise",
-	"exhaust",
-	"exhibit",
-	"exile",
-	"exist",
-	"exit",
-	"exotic",
-	"expand",
-	"expect",
-	"expire",
-	"explain",
-	"expose",
-	"express",
-	"extend",
-	"extra",
-	"eye",
-	"eyebrow",
-	"fabric",
-	"face",
-	"faculty",
-	"fade",
-	"faint",
-	"faith",
-	"fall",
-	"false",
-	"fame",
-	"family",
-	"famous",
-	"fan",
-	"fancy",
-	"fantasy",
-	"farm",
-	"fashion",
-	"fat",
-	"fatal",
-	"father",
-	"fatigue",
-	"fault",
-	"favorite",
-	"feature",
-	"february",
-	"federal",
-	"fee",
-	"feed",
-	"feel",
-	"female",
-	"fence",
-	"festival",
-	"fetch",
-	"fever",
-	"few",
-	"fiber",
-	"fiction",
-	"field",
-	"figure",
-	"file",
-	"film",
-	"filter",
-	"final",
-	"find",
-	"fine",
-	"finger",
-	"finish",
-	"fire",
-	"firm",
-	"first",
-	"fiscal",
-	"fish",
-	"fit",
-	"fitness",
-	"fix",
-	"flag",
-	"flame",
-	"flash",
-	"flat",
-	"flavor",
-	"flee",
-	"flight",
-	"flip",
-	"float",
-	"flock",
-	"floor",
-	"flower",
-	"fluid",
-	"flush",
-	"fly",
-	"foam",
-	"focus",
-	"fog",
-	"foil",
-	"fold",
-	"follow",
-	"food",
-	"foot",
-	"force",
-	"forest",
-	"forget",
-	"fork",
-	"fortune",
-	"forum",
-	"forward",
-	"fossil",
-	"foster",
-	"found",
-	"fox",
-	"fragile",
-	"frame",
-	"frequent",
-	"fresh",
-	"friend",
-	"fringe",
-	"frog",
-	"front",
-	"frost",
-	"frown",
-	"frozen",
-	"fruit",
-	"fuel",
-	"fun",
-	"funny",
-	"furnace",
-	"fury",
-	"future",
-	"gadget",
-	"gain",
-	"galaxy",
-	"gallery",
-	"game",
-	"gap",
-	"garage",
-	"garbage",
-	"garden",
-	"garlic",
-	"garment",
-	"gas",
-	"gasp",
-	"gate",
-	"gather",
-	"gauge",
-	"gaze",
-	"general",
-	"genius",
-	"genre",
-	"gentle",
-	"genuine",
-	"gesture",
-	"ghost",
-	"giant",
-	"gift",
-	"giggle",
-	"ginger",
-	"giraffe",
-	"girl",
-	"give",
-	"glad",
-	"glance",
-	"glare",
-	"glass",
-	"glide",
-	"glimpse",
-	"globe",
-	"gloom",
-	"glory",
-	"glove",
-	"glow",
-	"glue",
-	"goat",
-	"goddess",
-	"gold",
-	"good",
-	"goose",
-	"gorilla",
-	"gospel",
-	"gossip",
-	"govern",
-	"gown",
-	"grab",
-	"grace",
-	"grain",
-	"grant",
-	"grape",
-	"grass",
-	"gravity",
-	"great",
-	"green",
-	"grid",
-	"grief",
-	"grit",
-	"grocery",
-	"group",
-	"grow",
-	"grunt",
-	"guard",
-	"guess",
-	"guide",
-	"guilt",
-	"guitar",
-	"gun",
-	"gym",
-	"habit",
-	"hair",
-	"half",
-	"hammer",
-	"hamster",
-	"hand",
-	"happy",
-	"harbor",
-	"hard",
-	"harsh",
-	"harvest",
-	"hat",
-	"have",
-	"hawk",
-	"hazard",
-	"head",
-	"health",
-	"heart",
-	"heavy",
-	"hedgehog",
-	"height",
-	"hello",
-	"helmet",
-	"help",
-	"hen",
-	"hero",
-	"hidden",
-	"high",
-	"hill",
-	"hint",
-	"hip",
-	"hire",
-	"history",
-	"hobby",
-	"hockey",
-	"hold",
-	"hole",
-	"holiday",
-	"hollow",
-	"home",
-	"honey",
-	"hood",
-	"hope",
-	"horn",
-	"horror",
-	"horse",
-	"hospital",
-	"host",
-	"hotel",
-	"hour",
-	"hover",
-	"hub",
-	"huge",
-	"human",
-	"humble",
-	"humor",
-	"hundred",
-	"hungry",
-	"hunt",
-	"hurdle",
-	"hurry",
-	"hurt",
-	"husband",
-	"hybrid",
-	"ice",
-	"icon",
-	"idea",
-	"identify",
-	"idle",
-	"ignore",
-	"ill",
-	"illegal",
-	"illness",
-	"image",
-	"imitate",
-	"immense",
-	"immune",
-	"impact",
-	"impose",
-	"improve",
-	"impulse",
-	"inch",
-	"include",
-	"income",
-	"increase",
-	"index",
-	"indicate",
-	"indoor",
-	"industry",
-	"infant",
-	"inflict",
-	"inform",
-	"inhale",
-	"inherit",
-	"initial",
-	"inject",
-	"injury",
-	"inmate",
-	"inner",
-	"innocent",
-	"input",
-	"inquiry",
-	"insane",
-	"insect",
-	"inside",
-	"inspire",
-	"install",
-	"intact",
-	"interest",
-	"into",
-	"invest",
-	"invite",
-	"involve",
-	"iron",
-	"island",
-	"isolate",
-	"issue",
-	"item",
-	"ivory",
-	"jacket",
-	"jaguar",
-	"jar",
-	"jazz",
-	"jealous",
-	"jeans",
-	"jelly",
-	"jewel",
-	"job",
-	"join",
-	"joke",
-	"journey",
-	"joy",
-	"judge",
-	"juice",
-	"jump",
-	"jungle",
-	"junior",
-	"junk",
-	"just",
-	"kangaroo",
-	"keen",
-	"keep",
-	"ketchup",
-	"key",
-	"kick",
-	"kid",
-	"kidney",
-	"kind",
-	"kingdom",
-	"kiss",
-	"kit",
-	"kitchen",
-	"kite",
-	"kitten",
-	"kiwi",
-	"knee",
-	"knife",
-	"knock",
-	"know",
-	"lab",
-	"label",
-	"labor",
-	"ladder",
-	"lady",
-	"lake",
-	"lamp",
-	"language",
-	"laptop",
-	"large",
-	"later",
-	"latin",
-	"laugh",
-	"laundry",
-	"lava",
-	"law",
-	"lawn",
-	"lawsuit",
-	"layer",
-	"lazy",
-	"leader",
-	"leaf",
-	"learn",
-	"leave",
-	"lecture",
-	"left",
-	"leg",
-	"legal",
-	"legend",
-	"leisure",
-	"lemon",
-	"lend",
-	"length",
-	"lens",
-	"leopard",
-	"lesson",
-	"letter",
-	"level",
-	"liar",
-	"liberty",
-	"library",
-	"license",
-	"life",
-	"lift",
-	"light",
-	"like",
-	"limb",
-	"limit",
-	"link",
-	"lion",
-	"liquid",
-	"list",
-	"little",
-	"live",
-	"lizard",
-	"load",
-	"loan",
-	"lobster",
-	"local",
-	"lock",
-	"logic",
-	"lonely",
-	"long",
-	"loop",
-	"lottery",
-	"loud",
-	"lounge",
-	"love",
-	"loyal",
-	"lucky",
-	"luggage",
-	"lumber",
-	"lunar",
-	"lunch",
-	"luxury",
-	"lyrics",
-	"machine",
-	"mad",
-	"magic",
-	"magnet",
-	"maid",
-	"mail",
-	"main",
-	"major",
-	"make",
-	"mammal",
-	"man",
-	"manage",
-	"mandate",
-	"mango",
-	"mansion",
-	"manual",
-	"maple",
-	"marble",
-	"march",
-	"margin",
-	"marine",
-	"market",
-	"marriage",
-	"mask",
-	"mass",
-	"master",
-	"match",
-	"material",
-	"math",
-	"matrix",
-	"matter",
-	"maximum",
-	"maze",
-	"meadow",
-	"mean",
-	"measure",
-	"meat",
-	"mechanic",
-	"medal",
-	"media",
-	"melody",
-	"melt",
-	"member",
-	"memory",
-	"mention",
-	"menu",
-	"mercy",
-	"merge",
-	"merit",
-	"merry",
-	"mesh",
-	"message",
-	"metal",
-	"method",
-	"middle",
-	"midnight",
-	"milk",
-	"million",
-	"mimic",
-	"mind",
-	"minimum",
-	"minor",
-	"minute",
-	"miracle",
-	"mirror",
-	"misery",
-	"miss",
-	"mistake",
-	"mix",
-	"mixed",
-	"mixture",
-	"mobile",
-	"model",
-	"modify",
-	"mom",
-	"moment",
-	"monitor",
-	"monkey",
-	"monster",
-	"month",
-	"moon",
-	"moral",
-	"more",
-	"morning",
-	"mosquito",
-	"mother",
-	"motion",
-	"motor",
-	"mountain",
-	"mouse",
-	"move",
-	"movie",
-	"much",
-	"muffin",
-	"mule",
-	"multiply",
-	"muscle",
-	"museum",
-	"mushroom",
-	"music",
-	"must",
-	"mutual",
-	"myself",
-	"mystery",
-	"myth",
-	"naive",
-	"name",
-	"napkin",
-	"narrow",
-	"nasty",
-	"nation",
-	"nature",
-	"near",
-	"neck",
-	"need",
-	"negative",
-	"neglect",
-	"neither",
-	"nephew",
-	"nerve",
-	"nest",
-	"net",
-	"network",
-	"neutral",
-	"never",
-	"news",
-	"next",
-	"nice",
-	"night",
-	"noble",
-	"noise",
-	"nominee",
-	"noodle",
-	"normal",
-	"north",
-	"nose",
-	"notable",
-	"note",
-	"nothing",
-	"notice",
-	"novel",
-	"now",
-	"nuclear",
-	"number",
-	"nurse",
-	"nut",
-	"oak",
-	"obey",
-	"object",
-	"oblige",
-	"obscure",
-	"observe",
-	"obtain",
-	"obvious",
-	"occur",
-	"ocean",
-	"october",
-	"odor",
-	"off",
-	"offer",
-	"office",
-	"often",
-	"oil",
-	"okay",
-	"old",
-	"olive",
-	"olympic",
-	"omit",
-	"once",
-	"one",
-	"onion",
-	"online",
-	"only",
-	"open",
-	"opera",
-	"opinion",
-	"oppose",
-	"option",
-	"orange",
-	"orbit",
-	"orchard",
-	"order",
-	"ordinary",
-	"organ",
-	"orient",
-	"original",
-	"orphan",
-	"ostrich",
-	"other",
-	"outdoor",
-	"outer",
-	"output",
-	"outside",
-	"oval",
-	"oven",
-	"over",
-	"own",
-	"owner",
-	"oxygen",
-	"oyster",
-	"ozone",
-	"pact",
-	"paddle",
-	"page",
-	"pair",
-	"palace",
-	"palm",
-	"panda",
-	"panel",
-	"panic",
-	"panther",
-	"paper",
-	"parade",
-	"parent",
-	"park",
-	"parrot",
-	"party",
-	"pass",
-	"patch",
-	"path",
-	"patient",
-	"patrol",
-	"pattern",
-	"pause",
-	"pave",
-	"payment",
-	"peace",
-	"peanut",
-	"pear",
-	"peasant",
-	"pelican",
-	"pen",
-	"penalty",
-	"pencil",
-	"people",
-	"pepper",
-	"perfect",
-	"permit",
-	"person",
-	"pet",
-	"phone",
-	"photo",
-	"phrase",
-	"physical",
-	"piano",
-	"picnic",
-	"picture",
-	"piece",
-	"pig",
-	"pigeon",
-	"pill",
-	"pilot",
-	"pink",
-	"pioneer",
-	"pipe",
-	"pistol",
-	"pitch",
-	"pizza",
-	"place",
-	"planet",
-	"plastic",
-	"plate",
-	"play",
-	"please",
-	"pledge",
-	"pluck",
-	"plug",
-	"plunge",
-	"poem",
-	"poet",
-	"point",
-	"polar",
-	"pole",
-	"police",
-	"pond",
-	"pony",
-	"pool",
-	"popular",
-	"portion",
-	"position",
-	"possible",
-	"post",
-	"potato",
-	"pottery",
-	"poverty",
-	"powder",
-	"power",
-	"practice",
-	"praise",
-	"predict",
-	"prefer",
-	"prepare",
-	"present",
-	"pretty",
-	"prevent",
-	"price",
-	"pride",
-	"primary",
-	"print",
-	"priority",
-	"prison",
-	"private",
-	"prize",
-	"problem",
-	"process",
-	"produce",
-	"profit",
-	"program",
-	"project",
-	"promote",
-	"proof",
-	"property",
-	"prosper",
-	"protect",
-	"proud",
-	"provide",
-	"public",
-	"pudding",
-	"pull",
-	"pulp",
-	"pulse",
-	"pumpkin",
-	"punch",
-	"pupil",
-	"puppy",
-	"purchase",
-	"purity",
-	"purpose",
-	"purse",
-	"push",
-	"put",
-	"puzzle",
-	"pyramid",
-	"quality",
-	"quantum",
-	"quarter",
-	"question",
-	"quick",
-	"quit",
-	"quiz",
-	"quote",
-	"rabbit",
-	"raccoon",
-	"race",
-	"rack",
-	"radar",
-	"radio",
-	"rail",
-	"rain",
-	"raise",
-	"rally",
-	"ramp",
-	"ranch",
-	"random",
-	"range",
-	"rapid",
-	"rare",
-	"rate",
-	"rather",
-	"raven",
-	"raw",
-	"razor",
-	"ready",
-	"real",
-	"reason",
-	"rebel",
-	"rebuild",
-	"recall",
-	"receive",
-	"recipe",
-	"record",
-	"recycle",
-	"reduce",
-	"reflect",
-	"reform",
-	"refuse",
-	"region",
-	"regret",
-	"regular",
-	"reject",
-	"relax",
-	"release",
-	"relief",
-	"rely",
-	"remain",
-	"remember",
-	"remind",
-	"remove",
-	"render",
-	"renew",
-	"rent",
-	"reopen",
-	"repair",
-	"repeat",
-	"replace",
-	"report",
-	"require",
-	"rescue",
-	"resemble",
-	"resist",
-	"resource",
-	"response",
-	"result",
-	"retire",
-	"retreat",
-	"return",
-	"reunion",
-	"reveal",
-	"review",
-	"reward",
-	"rhythm",
-	"rib",
-	"ribbon",
-	"rice",
-	"rich",
-	"ride",
-	"ridge",
-	"rifle",
-	"right",
-	"rigid",
-	"ring",
-	"riot",
-	"ripple",
-	"risk",
-	"ritual",
-	"rival",
-	"river",
-	"road",
-	"roast",
-	"robot",
-	"robust",
-	"rocket",
-	"romance",
-	"roof",
-	"rookie",
-	"room",
-	"rose",
-	"rotate",
-	"rough",
-	"round",
-	"route",
-	"royal",
-	"rubber",
-	"rude",
-	"rug",
-	"rule",
-	"run",
-	"runway",
-	"rural",
-	"sad",
-	"saddle",
-	"sadness",
-	"safe",
-	"sail",
-	"salad",
-	"salmon",
-	"salon",
-	"salt",
-	"salute",
-	"same",
-	"sample",
-	"sand",
-	"satisfy",
-	"satoshi",
-	"sauce",
-	"sausage",
-	"save",
-	"say",
-	"scale",
-	"scan",
-	"scare",
-	"scatter",
-	"scene",
-	"scheme",
-	"school",
-	"science",
-	"scissors",
-	"scorpion",
-	"scout",
-	"scrap",
-	"screen",
-	"script",
-	"scrub",
-	"sea",
-	"search",
-	"season",
-	"seat",
-	"second",
-	"secret",
-	"section",
-	"security",
-	"seed",
-	"seek",
-	"segment",
-	"select",
-	"sell",
-	"seminar",
-	"senior",
-	"sense",
-	"sentence",
-	"series",
-	"service",
-	"session",
-	"settle",
-	"setup",
-	"seven",
-	"shadow",
-	"shaft",
-	"shallow",
-	"share",
-	"shed",
-	"shell",
-	"sheriff",
-	"shield",
-	"shift",
-	"shine",
-	"ship",
-	"shiver",
-	"shock",
-	"shoe",
-	"shoot",
-	"shop",
-	"short",
-	"shoulder",
-	"shove",
-	"shrimp",
-	"shrug",
-	"shuffle",
-	"shy",
-	"sibling",
-	"sick",
-	"side",
-	"siege",
-	"sight",
-	"sign",
-	"silent",
-	"silk",
-	"silly",
-	"silver",
-	"similar",
-	"simple",
-	"since",
-	"sing",
-	"siren",
-	"sister",
-	"situate",
-	"six",
-	"size",
-	"skate",
-	"sketch",
-	"ski",
-	"skill",
-	"skin",
-	"skirt",
-	"skull",
-	"slab",
-	"slam",
-	"sleep",
-	"slender",
-	"slice",
-	"slide",
-	"slight",
-	"slim",
-	"slogan",
-	"slot",
-	"slow",
-	"slush",
-	"small",
-	"smart",
-	"smile",
-	"smoke",
-	"smooth",
-	"snack",
-	"snake",
-	"snap",
-	"sniff",
-	"snow",
-	"soap",
-	"soccer",
-	"social",
-	"sock",
-	"soda",
-	"soft",
-	"solar",
-	"soldier",
-	"solid",
-	"solution",
-	"solve",
-	"someone",
-	"song",
-	"soon",
-	"sorry",
-	"sort",
-	"soul",
-	"sound",
-	"soup",
-	"source",
-	"south",
-	"space",
-	"spare",
-	"spatial",
-	"spawn",
-	"speak",
-	"special",
-	"speed",
-	"spell",
-	"spend",
-	"sphere",
-	"spice",
-	"spider",
-	"spike",
-	"spin",
-	"spirit",
-	"split",
-	"spoil",
-	"sponsor",
-	"spoon",
-	"sport",
-	"spot",
-	"spray",
-	"spread",
-	"spring",
-	"spy",
-	"square",
-	"squeeze",
-	"squirrel",
-	"stable",
-	"stadium",
-	"staff",
-	"stage",
-	"stairs",
-	"stamp",
-	"stand",
-	"start",
-	"state",
-	"stay",
-	"steak",
-	"steel",
-	"stem",
-	"step",
-	"stereo",
-	"stick",
-	"still",
-	"sting",
-	"stock",
-	"stomach",
-	"stone",
-	"stool",
-	"story",
-	"stove",
-	"strategy",
-	"street",
-	"strike",
-	"strong",
-	"struggle",
-	"student",
-	"stuff",
-	"stumble",
-	"style",
-	"subject",
-	"submit",
-	"subway",
-	"success",
-	"such",
-	"sudden",
-	"suffer",
-	"sugar",
-	"suggest",
-	"suit",
-	"summer",
-	"sun",
-	"sunny",
-	"sunset",
-	"super",
-	"supply",
-	"supreme",
-	"sure",
-	"surface",
-	"surge",
-	"surprise",
-	"surround",
-	"survey",
-	"suspect",
-	"sustain",
-	"swallow",
-	"swamp",
-	"swap",
-	"swarm",
-	"swear",
-	"sweet",
-	"swift",
-	"swim",
-	"swing",
-	"switch",
-	"sword",
-	"symbol",
-	"symptom",
-	"syrup",
-	"system",
-	"table",
-	"tackle",
-	"tag",
-	"tail",
-	"talent",
-	"talk",
-	"tank",
-	"tape",
-	"target",
-	"task",
-	"taste",
-	"tattoo",
-	"taxi",
-	"teach",
-	"team",
-	"tell",
-	"ten",
-	"tenant",
-	"tennis",
-	"tent",
-	"term",
-	"test",
-	"text",
-	"thank",
-	"that",
-	"theme",
-	"then",
-	"theory",
-	"there",
-	"they",
-	"thing",
-	"this",
-	"thought",
-	"three",
-	"thrive",
-	"throw",
-	"thumb",
-	"thunder",
-	"ticket",
-	"tide",
-	"tiger",
-	"tilt",
-	"timber",
-	"time",
-	"tiny",
-	"tip",
-	"tired",
-	"tissue",
-	"title",
-	"toast",
-	"tobacco",
-	"today",
-	"toddler",
-	"toe",
-	"together",
-	"toilet",
-	"token",
-	"tomato",
-	"tomorrow",
-	"tone",
-	"tongue",
-	"tonight",
-	"tool",
-	"tooth",
-	"top",
-	"topic",
-	"topple",
-	"torch",
-	"tornado",
-	"tortoise",
-	"toss",
-	"total",
-	"tourist",
-	"toward",
-	"tower",
-	"town",
-	"toy",
-	"track",
-	"trade",
-	"traffic",
-	"tragic",
-	"train",
-	"transfer",
-	"trap",
-	"trash",
-	"travel",
-	"tray",
-	"treat",
-	"tree",
-	"trend",
-	"trial",
-	"tribe",
-	"trick",
-	"trigger",
-	"trim",
-	"trip",
-	"trophy",
-	"trouble",
-	"truck",
-	"true",
-	"truly",
-	"trumpet",
-	"trust",
-	"truth",
-	"try",
-	"tube",
-	"tuition",
-	"tumble",
-	"tuna",
-	"tunnel",
-	"turkey",
-	"turn",
-	"turtle",
-	"twelve",
-	"twenty",
-	"twice",
-	"twin",
-	"twist",
-	"two",
-	"type",
-	"typical",
-	"ugly",
-	"umbrella",
-	"unable",
-	"unaware",
-	"uncle",
-	"uncover",
-	"under",
-	"undo",
-	"unfair",
-	"unfold",
-	"unhappy",
-	"uniform",
-	"unique",
-	"unit",
-	"universe",
-	"unknown",
-	"unlock",
-	"until",
-	"unusual",
-	"unveil",
-	"update",
-	"upgrade",
-	"uphold",
-	"upon",
-	"upper",
-	"upset",
-	"urban",
-	"urge",
-	"usage",
-	"use",
-	"used",
-	"useful",
-	"useless",
-	"usual",
-	"utility",
-	"vacant",
-	"vacuum",
-	"vague",
-	"valid",
-	"valley",
-	"valve",
-	"van",
-	"vanish",
-	"vapor",
-	"various",
-	"vast",
-	"vault",
-	"vehicle",
-	"velvet",
-	"vendor",
-	"venture",
-	"venue",
-	"verb",
-	"verify",
-	"version",
-	"very",
-	"vessel",
-	"veteran",
-	"viable",
-	"vibrant",
-	"vicious",
-	"victory",
-	"video",
-	"view",
-	"village",
-	"vintage",
-	"violin",
-	"virtual",
-	"virus",
-	"visa",
-	"visit",
-	"visual",
-	"vital",
-	"vivid",
-	"vocal",
-	"voice",
-	"void",
-	"volcano",
-	"volume",
-	"vote",
-	"voyage",
-	"wage",
-	"wagon",
-	"wait",
-	"walk",
-	"wall",
-	"walnut",
-	"want",
-	"warfare",
-	"warm",
-	"warrior",
-	"wash",
-	"wasp",
-	"waste",
-	"water",
-	"wave",
-	"way",
-	"wealth",
-	"weapon",
-	"wear",
-	"weasel",
-	"weather",
-	"web",
-	"wedding",
-	"weekend",
-	"weird",
-	"welcome",
-	"west",
-	"wet",
-	"whale",
-	"what",
-	"wheat",
-	"wheel",
-	"when",
-	"where",
-	"whip",
-	"whisper",
-	"wide",
-	"width",
-	"wife",
-	"wild",
-	"will",
-	"win",
-	"window",
-	"wine",
-	"wing",
-	"wink",
-	"winner",
-	"winter",
-	"wire",
-	"wisdom",
-	"wise",
-	"wish",
-	"witness",
-	"wolf",
-	"woman",
-	"wonder",
-	"wood",
-	"wool",
-	"word",
-	"work",
-	"world",
-	"worry",
-	"worth",
-	"wrap",
-	"wreck",
-	"wrestle",
-	"wrist",
-	"write",
-	"wrong",
-	"yard",
-	"year",
-	"yellow",
-	"you",
-	"young",
-	"youth",
-	"zebra",
-	"zero",
-	"zone",
-	"zoo",
+#define WORDLIST(W) \
+	W("abandon") \
+	W("ability") \
+	W("able") \
+	W("about") \
+	W("above") \
+	W("absent") \
+	W("absorb") \
+	W("abstract") \
+	W("absurd") \
+	W("abuse") \
+	W("access") \
+	W("accident") \
+	W("account") \
+	W("accuse") \
+	W("achieve") \
+	W("acid") \
+	W("acoustic") \
+	W("acquire") \
+	W("across") \
+	W("act") \
+	W("action") \
+	W("actor") \
+	W("actress") \
+	W("actual") \
+	W("adapt") \
+	W("add") \
+	W("addict") \
+	W("address") \
+	W("adjust") \
+	W("admit") \
+	W("adult") \
+	W("advance") \
+	W("advice") \
+	W("aerobic") \
+	W("affair") \
+	W("afford") \
+	W("afraid") \
+	W("again") \
+	W("age") \
+	W("agent") \
+	W("agree") \
+	W("ahead") \
+	W("aim") \
+	W("air") \
+	W("airport") \
+	W("aisle") \
+	W("alarm") \
+	W("album") \
+	W("alcohol") \
+	W("alert") \
+	W("alien") \
+	W("all") \
+	W("alley") \
+	W("allow") \
+	W("almost") \
+	W("alone") \
+	W("alpha") \
+	W("already") \
+	W("also") \
+	W("alter") \
+	W("always") \
+	W("amateur") \
+	W("amazing") \
+	W("among") \
+	W("amount") \
+	W("amused") \
+	W("analyst") \
+	W("anchor") \
+	W("ancient") \
+	W("anger") \
+	W("angle") \
+	W("angry") \
+	W("animal") \
+	W("ankle") \
+	W("announce") \
+	W("annual") \
+	W("another") \
+	W("answer") \
+	W("antenna") \
+	W("antique") \
+	W("anxiety") \
+	W("any") \
+	W("apart") \
+	W("apology") \
+	W("appear") \
+	W("apple") \
+	W("approve") \
+	W("april") \
+	W("arch") \
+	W("arctic") \
+	W("area") \
+	W("arena") \
+	W("argue") \
+	W("arm") \
+	W("armed") \
+	W("armor") \
+	W("army") \
+	W("around") \
+	W("arrange") \
+	W("arrest") \
+	W("arrive") \
+	W("arrow") \
+	W("art") \
+	W("artefact") \
+	W("artist") \
+	W("artwork") \
+	W("ask") \
+	W("aspect") \
+	W("assault") \
+	W("asset") \
+	W("assist") \
+	W("assume") \
+	W("asthma") \
+	W("athlete") \
+	W("atom") \
+	W("attack") \
+	W("attend") \
+	W("attitude") \
+	W("attract") \
+	W("auction") \
+	W("audit") \
+	W("august") \
+	W("aunt") \
+	W("author") \
+	W("auto") \
+	W("autumn") \
+	W("average") \
+	W("avocado") \
+	W("avoid") \
+	W("awake") \
+	W("aware") \
+	W("away") \
+	W("awesome") \
+	W("awful") \
+	W("awkward") \
+	W("axis") \
+	W("baby") \
+	W("bachelor") \
+	W("bacon") \
+	W("badge") \
+	W("bag") \
+	W("balance") \
+	W("balcony") \
+	W("ball") \
+	W("bamboo") \
+	W("banana") \
+	W("banner") \
+	W("bar") \
+	W("barely") \
+	W("bargain") \
+	W("barrel") \
+	W("base") \
+	W("basic") \
+	W("basket") \
+	W("battle") \
+	W("beach") \
+	W("bean") \
+	W("beauty") \
+	W("because") \
+	W("become") \
+	W("beef") \
+	W("before") \
+	W("begin") \
+	W("behave") \
+	W("behind") \
+	W("believe") \
+	W("below") \
+	W("belt") \
+	W("bench") \
+	W("benefit") \
+	W("best") \
+	W("betray") \
+	W("better") \
+	W("between") \
+	W("beyond") \
+	W("bicycle") \
+	W("bid") \
+	W("bike") \
+	W("bind") \
+	W("biology") \
+	W("bird") \
+	W("birth") \
+	W("bitter") \
+	W("black") \
+	W("blade") \
+	W("blame") \
+	W("blanket") \
+	W("blast") \
+	W("bleak") \
+	W("bless") \
+	W("blind") \
+	W("blood") \
+	W("blossom") \
+	W("blouse") \
+	W("blue") \
+	W("blur") \
+	W("blush") \
+	W("board") \
+	W("boat") \
+	W("body") \
+	W("boil") \
+	W("bomb") \
+	W("bone") \
+	W("bonus") \
+	W("book") \
+	W("boost") \
+	W("border") \
+	W("boring") \
+	W("borrow") \
+	W("boss") \
+	W("bottom") \
+	W("bounce") \
+	W("box") \
+	W("boy") \
+	W("bracket") \
+	W("brain") \
+	W("brand") \
+	W("brass") \
+	W("brave") \
+	W("bread") \
+	W("breeze") \
+	W("brick") \
+	W("bridge") \
+	W("brief") \
+	W("bright") \
+	W("bring") \
+	W("brisk") \
+	W("broccoli") \
+	W("broken") \
+	W("bronze") \
+	W("broom") \
+	W("brother") \
+	W("brown") \
+	W("brush") \
+	W("bubble") \
+	W("buddy") \
+	W("budget") \
+	W("buffalo") \
+	W("build") \
+	W("bulb") \
+	W("bulk") \
+	W("bullet") \
+	W("bundle") \
+	W("bunker") \
+	W("burden") \
+	W("burger") \
+	W("burst") \
+	W("bus") \
+	W("business") \
+	W("busy") \
+	W("butter") \
+	W("buyer") \
+	W("buzz") \
+	W("cabbage") \
+	W("cabin") \
+	W("cable") \
+	W("cactus") \
+	W("cage") \
+	W("cake") \
+	W("call") \
+	W("calm") \
+	W("camera") \
+	W("camp") \
+	W("can") \
+	W("canal") \
+	W("cancel") \
+	W("candy") \
+	W("cannon") \
+	W("canoe") \
+	W("canvas") \
+	W("canyon") \
+	W("capable") \
+	W("capital") \
+	W("captain") \
+	W("car") \
+	W("carbon") \
+	W("card") \
+	W("cargo") \
+	W("carpet") \
+	W("carry") \
+	W("cart") \
+	W("case") \
+	W("cash") \
+	W("casino") \
+	W("castle") \
+	W("casual") \
+	W("cat") \
+	W("catalog") \
+	W("catch") \
+	W("category") \
+	W("cattle") \
+	W("caught") \
+	W("cause") \
+	W("caution") \
+	W("cave") \
+	W("ceiling") \
+	W("celery") \
+	W("cement") \
+	W("census") \
+	W("century") \
+	W("cereal") \
+	W("certain") \
+	W("chair") \
+	W("chalk") \
+	W("champion") \
+	W("change") \
+	W("chaos") \
+	W("chapter") \
+	W("charge") \
+	W("chase") \
+	W("chat") \
+	W("cheap") \
+	W("check") \
+	W("cheese") \
+	W("chef") \
+	W("cherry") \
+	W("chest") \
+	W("chicken") \
+	W("chief") \
+	W("child") \
+	W("chimney") \
+	W("choice") \
+	W("choose") \
+	W("chronic") \
+	W("chuckle") \
+	W("chunk") \
+	W("churn") \
+	W("cigar") \
+	W("cinnamon") \
+	W("circle") \
+	W("citizen") \
+	W("city") \
+	W("civil") \
+	W("claim") \
+	W("clap") \
+	W("clarify") \
+	W("claw") \
+	W("clay") \
+	W("clean") \
+	W("clerk") \
+	W("clever") \
+	W("click") \
+	W("client") \
+	W("cliff") \
+	W("climb") \
+	W("clinic") \
+	W("clip") \
+	W("clock") \
+	W("clog") \
+	W("close") \
+	W("cloth") \
+	W("cloud") \
+	W("clown") \
+	W("club") \
+	W("clump") \
+	W("cluster") \
+	W("clutch") \
+	W("coach") \
+	W("coast") \
+	W("coconut") \
+	W("code") \
+	W("coffee") \
+	W("coil") \
+	W("coin") \
+	W("collect") \
+	W("color") \
+	W("column") \
+	W("combine") \
+	W("come") \
+	W("comfort") \
+	W("comic") \
+	W("common") \
+	W("company") \
+	W("concert") \
+	W("conduct") \
+	W("confirm") \
+	W("congress") \
+	W("connect") \
+	W("consider") \
+	W("control") \
+	W("convince") \
+	W("cook") \
+	W("cool") \
+	W("copper") \
+	W("copy") \
+	W("coral") \
+	W("core") \
+	W("corn") \
+	W("correct") \
+	W("cost") \
+	W("cotton") \
+	W("couch") \
+	W("country") \
+	W("couple") \
+	W("course") \
+	W("cousin") \
+	W("cover") \
+	W("coyote") \
+	W("crack") \
+	W("cradle") \
+	W("craft") \
+	W("cram") \
+	W("crane") \
+	W("crash") \
+	W("crater") \
+	W("crawl") \
+	W("crazy") \
+	W("cream") \
+	W("credit") \
+	W("creek") \
+	W("crew") \
+	W("cricket") \
+	W("crime") \
+	W("crisp") \
+	W("critic") \
+	W("crop") \
+	W("cross") \
+	W("crouch") \
+	W("crowd") \
+	W("crucial") \
+	W("cruel") \
+	W("cruise") \
+	W("crumble") \
+	W("crunch") \
+	W("crush") \
+	W("cry") \
+	W("crystal") \
+	W("cube") \
+	W("culture") \
+	W("cup") \
+	W("cupboard") \
+	W("curious") \
+	W("current") \
+	W("curtain") \
+	W("curve") \
+	W("cushion") \
+	W("custom") \
+	W("cute") \
+	W("cycle") \
+	W("dad") \
+	W("damage") \
+	W("damp") \
+	W("dance") \
+	W("danger") \
+	W("daring") \
+	W("dash") \
+	W("daughter") \
+	W("dawn") \
+	W("day") \
+	W("deal") \
+	W("debate") \
+	W("debris") \
+	W("decade") \
+	W("december") \
+	W("decide") \
+	W("decline") \
+	W("decorate") \
+	W("decrease") \
+	W("deer") \
+	W("defense") \
+	W("define") \
+	W("defy") \
+	W("degree") \
+	W("delay") \
+	W("deliver") \
+	W("demand") \
+	W("demise") \
+	W("denial") \
+	W("dentist") \
+	W("deny") \
+	W("depart") \
+	W("depend") \
+	W("deposit") \
+	W("depth") \
+	W("deputy") \
+	W("derive") \
+	W("describe") \
+	W("desert") \
+	W("design") \
+	W("desk") \
+	W("despair") \
+	W("destroy") \
+	W("detail") \
+	W("detect") \
+	W("develop") \
+	W("device") \
+	W("devote") \
+	W("diagram") \
+	W("dial") \
+	W("diamond") \
+	W("diary") \
+	W("dice") \
+	W("diesel") \
+	W("diet") \
+	W("differ") \
+	W("digital") \
+	W("dignity") \
+	W("dilemma") \
+	W("dinner") \
+	W("dinosaur") \
+	W("direct") \
+	W("dirt") \
+	W("disagree") \
+	W("discover") \
+	W("disease") \
+	W("dish") \
+	W("dismiss") \
+	W("disorder") \
+	W("display") \
+	W("distance") \
+	W("divert") \
+	W("divide") \
+	W("divorce") \
+	W("dizzy") \
+	W("doctor") \
+	W("document") \
+	W("dog") \
+	W("doll") \
+	W("dolphin") \
+	W("domain") \
+	W("donate") \
+	W("donkey") \
+	W("donor") \
+	W("door") \
+	W("dose") \
+	W("double") \
+	W("dove") \
+	W("draft") \
+	W("dragon") \
+	W("drama") \
+	W("drastic") \
+	W("draw") \
+	W("dream") \
+	W("dress") \
+	W("drift") \
+	W("drill") \
+	W("drink") \
+	W("drip") \
+	W("drive") \
+	W("drop") \
+	W("drum") \
+	W("dry") \
+	W("duck") \
+	W("dumb") \
+	W("dune") \
+	W("during") \
+	W("dust") \
+	W("dutch") \
+	W("duty") \
+	W("dwarf") \
+	W("dynamic") \
+	W("eager") \
+	W("eagle") \
+	W("early") \
+	W("earn") \
+	W("earth") \
+	W("easily") \
+	W("east") \
+	W("easy") \
+	W("echo") \
+	W("ecology") \
+	W("economy") \
+	W("edge") \
+	W("edit") \
+	W("educate") \
+	W("effort") \
+	W("egg") \
+	W("eight") \
+	W("either") \
+	W("elbow") \
+	W("elder") \
+	W("electric") \
+	W("elegant") \
+	W("element") \
+	W("elephant") \
+	W("elevator") \
+	W("elite") \
+	W("else") \
+	W("embark") \
+	W("embody") \
+	W("embrace") \
+	W("emerge") \
+	W("emotion") \
+	W("employ") \
+	W("empower") \
+	W("empty") \
+	W("enable") \
+	W("enact") \
+	W("end") \
+	W("endless") \
+	W("endorse") \
+	W("enemy") \
+	W("energy") \
+	W("enforce") \
+	W("engage") \
+	W("engine") \
+	W("enhance") \
+	W("enjoy") \
+	W("enlist") \
+	W("enough") \
+	W("enrich") \
+	W("enroll") \
+	W("ensure") \
+	W("enter") \
+	W("entire") \
+	W("entry") \
+	W("envelope") \
+	W("episode") \
+	W("equal") \
+	W("equip") \
+	W("era") \
+	W("erase") \
+	W("erode") \
+	W("erosion") \
+	W("error") \
+	W("erupt") \
+	W("escape") \
+	W("essay") \
+	W("essence") \
+	W("estate") \
+	W("eternal") \
+	W("ethics") \
+	W("evidence") \
+	W("evil") \
+	W("evoke") \
+	W("evolve") \
+	W("exact") \
+	W("example") \
+	W("excess") \
+	W("exchange") \
+	W("excite") \
+	W("exclude") \
+	W("excuse") \
+	W("execute") \
+	W("exercise") \
+	W("exhaust") \
+	W("exhibit") \
+	W("exile") \
+	W("exist") \
+	W("exit") \
+	W("exotic") \
+	W("expand") \
+	W("expect") \
+	W("expire") \
+	W("explain") \
+	W("expose") \
+	W("express") \
+	W("extend") \
+	W("extra") \
+	W("eye") \
+	W("eyebrow") \
+	W("fabric") \
+	W("face") \
+	W("faculty") \
+	W("fade") \
+	W("faint") \
+	W("faith") \
+	W("fall") \
+	W("false") \
+	W("fame") \
+	W("family") \
+	W("famous") \
+	W("fan") \
+	W("fancy") \
+	W("fantasy") \
+	W("farm") \
+	W("fashion") \
+	W("fat") \
+	W("fatal") \
+	W("father") \
+	W("fatigue") \
+	W("fault") \
+	W("favorite") \
+	W("feature") \
+	W("february") \
+	W("federal") \
+	W("fee") \
+	W("feed") \
+	W("feel") \
+	W("female") \
+	W("fence") \
+	W("festival") \
+	W("fetch") \
+	W("fever") \
+	W("few") \
+	W("fiber") \
+	W("fiction") \
+	W("field") \
+	W("figure") \
+	W("file") \
+	W("film") \
+	W("filter") \
+	W("final") \
+	W("find") \
+	W("fine") \
+	W("finger") \
+	W("finish") \
+	W("fire") \
+	W("firm") \
+	W("first") \
+	W("fiscal") \
+	W("fish") \
+	W("fit") \
+	W("fitness") \
+	W("fix") \
+	W("flag") \
+	W("flame") \
+	W("flash") \
+	W("flat") \
+	W("flavor") \
+	W("flee") \
+	W("flight") \
+	W("flip") \
+	W("float") \
+	W("flock") \
+	W("floor") \
+	W("flower") \
+	W("fluid") \
+	W("flush") \
+	W("fly") \
+	W("foam") \
+	W("focus") \
+	W("fog") \
+	W("foil") \
+	W("fold") \
+	W("follow") \
+	W("food") \
+	W("foot") \
+	W("force") \
+	W("forest") \
+	W("forget") \
+	W("fork") \
+	W("fortune") \
+	W("forum") \
+	W("forward") \
+	W("fossil") \
+	W("foster") \
+	W("found") \
+	W("fox") \
+	W("fragile") \
+	W("frame") \
+	W("frequent") \
+	W("fresh") \
+	W("friend") \
+	W("fringe") \
+	W("frog") \
+	W("front") \
+	W("frost") \
+	W("frown") \
+	W("frozen") \
+	W("fruit") \
+	W("fuel") \
+	W("fun") \
+	W("funny") \
+	W("furnace") \
+	W("fury") \
+	W("future") \
+	W("gadget") \
+	W("gain") \
+	W("galaxy") \
+	W("gallery") \
+	W("game") \
+	W("gap") \
+	W("garage") \
+	W("garbage") \
+	W("garden") \
+	W("garlic") \
+	W("garment") \
+	W("gas") \
+	W("gasp") \
+	W("gate") \
+	W("gather") \
+	W("gauge") \
+	W("gaze") \
+	W("general") \
+	W("genius") \
+	W("genre") \
+	W("gentle") \
+	W("genuine") \
+	W("gesture") \
+	W("ghost") \
+	W("giant") \
+	W("gift") \
+	W("giggle") \
+	W("ginger") \
+	W("giraffe") \
+	W("girl") \
+	W("give") \
+	W("glad") \
+	W("glance") \
+	W("glare") \
+	W("glass") \
+	W("glide") \
+	W("glimpse") \
+	W("globe") \
+	W("gloom") \
+	W("glory") \
+	W("glove") \
+	W("glow") \
+	W("glue") \
+	W("goat") \
+	W("goddess") \
+	W("gold") \
+	W("good") \
+	W("goose") \
+	W("gorilla") \
+	W("gospel") \
+	W("gossip") \
+	W("govern") \
+	W("gown") \
+	W("grab") \
+	W("grace") \
+	W("grain") \
+	W("grant") \
+	W("grape") \
+	W("grass") \
+	W("gravity") \
+	W("great") \
+	W("green") \
+	W("grid") \
+	W("grief") \
+	W("grit") \
+	W("grocery") \
+	W("group") \
+	W("grow") \
+	W("grunt") \
+	W("guard") \
+	W("guess") \
+	W("guide") \
+	W("guilt") \
+	W("guitar") \
+	W("gun") \
+	W("gym") \
+	W("habit") \
+	W("hair") \
+	W("half") \
+	W("hammer") \
+	W("hamster") \
+	W("hand") \
+	W("happy") \
+	W("harbor") \
+	W("hard") \
+	W("harsh") \
+	W("harvest") \
+	W("hat") \
+	W("have") \
+	W("hawk") \
+	W("hazard") \
+	W("head") \
+	W("health") \
+	W("heart") \
+	W("heavy") \
+	W("hedgehog") \
+	W("height") \
+	W("hello") \
+	W("helmet") \
+	W("help") \
+	W("hen") \
+	W("hero") \
+	W("hidden") \
+	W("high") \
+	W("hill") \
+	W("hint") \
+	W("hip") \
+	W("hire") \
+	W("history") \
+	W("hobby") \
+	W("hockey") \
+	W("hold") \
+	W("hole") \
+	W("holiday") \
+	W("hollow") \
+	W("home") \
+	W("honey") \
+	W("hood") \
+	W("hope") \
+	W("horn") \
+	W("horror") \
+	W("horse") \
+	W("hospital") \
+	W("host") \
+	W("hotel") \
+	W("hour") \
+	W("hover") \
+	W("hub") \
+	W("huge") \
+	W("human") \
+	W("humble") \
+	W("humor") \
+	W("hundred") \
+	W("hungry") \
+	W("hunt") \
+	W("hurdle") \
+	W("hurry") \
+	W("hurt") \
+	W("husband") \
+	W("hybrid") \
+	W("ice") \
+	W("icon") \
+	W("idea") \
+	W("identify") \
+	W("idle") \
+	W("ignore") \
+	W("ill") \
+	W("illegal") \
+	W("illness") \
+	W("image") \
+	W("imitate") \
+	W("immense") \
+	W("immune") \
+	W("impact") \
+	W("impose") \
+	W("improve") \
+	W("impulse") \
+	W("inch") \
+	W("include") \
+	W("income") \
+	W("increase") \
+	W("index") \
+	W("indicate") \
+	W("indoor") \
+	W("industry") \
+	W("infant") \
+	W("inflict") \
+	W("inform") \
+	W("inhale") \
+	W("inherit") \
+	W("initial") \
+	W("inject") \
+	W("injury") \
+	W("inmate") \
+	W("inner") \
+	W("innocent") \
+	W("input") \
+	W("inquiry") \
+	W("insane") \
+	W("insect") \
+	W("inside") \
+	W("inspire") \
+	W("install") \
+	W("intact") \
+	W("interest") \
+	W("into") \
+	W("invest") \
+	W("invite") \
+	W("involve") \
+	W("iron") \
+	W("island") \
+	W("isolate") \
+	W("issue") \
+	W("item") \
+	W("ivory") \
+	W("jacket") \
+	W("jaguar") \
+	W("jar") \
+	W("jazz") \
+	W("jealous") \
+	W("jeans") \
+	W("jelly") \
+	W("jewel") \
+	W("job") \
+	W("join") \
+	W("joke") \
+	W("journey") \
+	W("joy") \
+	W("judge") \
+	W("juice") \
+	W("jump") \
+	W("jungle") \
+	W("junior") \
+	W("junk") \
+	W("just") \
+	W("kangaroo") \
+	W("keen") \
+	W("keep") \
+	W("ketchup") \
+	W("key") \
+	W("kick") \
+	W("kid") \
+	W("kidney") \
+	W("kind") \
+	W("kingdom") \
+	W("kiss") \
+	W("kit") \
+	W("kitchen") \
+	W("kite") \
+	W("kitten") \
+	W("kiwi") \
+	W("knee") \
+	W("knife") \
+	W("knock") \
+	W("know") \
+	W("lab") \
+	W("label") \
+	W("labor") \
+	W("ladder") \
+	W("lady") \
+	W("lake") \
+	W("lamp") \
+	W("language") \
+	W("laptop") \
+	W("large") \
+	W("later") \
+	W("latin") \
+	W("laugh") \
+	W("laundry") \
+	W("lava") \
+	W("law") \
+	W("lawn") \
+	W("lawsuit") \
+	W("layer") \
+	W("lazy") \
+	W("leader") \
+	W("leaf") \
+	W("learn") \
+	W("leave") \
+	W("lecture") \
+	W("left") \
+	W("leg") \
+	W("legal") \
+	W("legend") \
+	W("leisure") \
+	W("lemon") \
+	W("lend") \
+	W("length") \
+	W("lens") \
+	W("leopard") \
+	W("lesson") \
+	W("letter") \
+	W("level") \
+	W("liar") \
+	W("liberty") \
+	W("library") \
+	W("license") \
+	W("life") \
+	W("lift") \
+	W("light") \
+	W("like") \
+	W("limb") \
+	W("limit") \
+	W("link") \
+	W("lion") \
+	W("liquid") \
+	W("list") \
+	W("little") \
+	W("live") \
+	W("lizard") \
+	W("load") \
+	W("loan") \
+	W("lobster") \
+	W("local") \
+	W("lock") \
+	W("logic") \
+	W("lonely") \
+	W("long") \
+	W("loop") \
+	W("lottery") \
+	W("loud") \
+	W("lounge") \
+	W("love") \
+	W("loyal") \
+	W("lucky") \
+	W("luggage") \
+	W("lumber") \
+	W("lunar") \
+	W("lunch") \
+	W("luxury") \
+	W("lyrics") \
+	W("machine") \
+	W("mad") \
+	W("magic") \
+	W("magnet") \
+	W("maid") \
+	W("mail") \
+	W("main") \
+	W("major") \
+	W("make") \
+	W("mammal") \
+	W("man") \
+	W("manage") \
+	W("mandate") \
+	W("mango") \
+	W("mansion") \
+	W("manual") \
+	W("maple") \
+	W("marble") \
+	W("march") \
+	W("margin") \
+	W("marine") \
+	W("market") \
+	W("marriage") \
+	W("mask") \
+	W("mass") \
+	W("master") \
+	W("match") \
+	W("material") \
+	W("math") \
+	W("matrix") \
+	W("matter") \
+	W("maximum") \
+	W("maze") \
+	W("meadow") \
+	W("mean") \
+	W("measure") \
+	W("meat") \
+	W("mechanic") \
+	W("medal") \
+	W("media") \
+	W("melody") \
+	W("melt") \
+	W("member") \
+	W("memory") \
+	W("mention") \
+	W("menu") \
+	W("mercy") \
+	W("merge") \
+	W("merit") \
+	W("merry") \
+	W("mesh") \
+	W("message") \
+	W("metal") \
+	W("method") \
+	W("middle") \
+	W("midnight") \
+	W("milk") \
+	W("million") \
+	W("mimic") \
+	W("mind") \
+	W("minimum") \
+	W("minor") \
+	W("minute") \
+	W("miracle") \
+	W("mirror") \
+	W("misery") \
+	W("miss") \
+	W("mistake") \
+	W("mix") \
+	W("mixed") \
+	W("mixture") \
+	W("mobile") \
+	W("model") \
+	W("modify") \
+	W("mom") \
+	W("moment") \
+	W("monitor") \
+	W("monkey") \
+	W("monster") \
+	W("month") \
+	W("moon") \
+	W("moral") \
+	W("more") \
+	W("morning") \
+	W("mosquito") \
+	W("mother") \
+	W("motion") \
+	W("motor") \
+	W("mountain") \
+	W("mouse") \
+	W("move") \
+	W("movie") \
+	W("much") \
+	W("muffin") \
+	W("mule") \
+	W("multiply") \
+	W("muscle") \
+	W("museum") \
+	W("mushroom") \
+	W("music") \
+	W("must") \
+	W("mutual") \
+	W("myself") \
+	W("mystery") \
+	W("myth") \
+	W("naive") \
+	W("name") \
+	W("napkin") \
+	W("narrow") \
+	W("nasty") \
+	W("nation") \
+	W("nature") \
+	W("near") \
+	W("neck") \
+	W("need") \
+	W("negative") \
+	W("neglect") \
+	W("neither") \
+	W("nephew") \
+	W("nerve") \
+	W("nest") \
+	W("net") \
+	W("network") \
+	W("neutral") \
+	W("never") \
+	W("news") \
+	W("next") \
+	W("nice") \
+	W("night") \
+	W("noble") \
+	W("noise") \
+	W("nominee") \
+	W("noodle") \
+	W("normal") \
+	W("north") \
+	W("nose") \
+	W("notable") \
+	W("note") \
+	W("nothing") \
+	W("notice") \
+	W("novel") \
+	W("now") \
+	W("nuclear") \
+	W("number") \
+	W("nurse") \
+	W("nut") \
+	W("oak") \
+	W("obey") \
+	W("object") \
+	W("oblige") \
+	W("obscure") \
+	W("observe") \
+	W("obtain") \
+	W("obvious") \
+	W("occur") \
+	W("ocean") \
+	W("october") \
+	W("odor") \
+	W("off") \
+	W("offer") \
+	W("office") \
+	W("often") \
+	W("oil") \
+	W("okay") \
+	W("old") \
+	W("olive") \
+	W("olympic") \
+	W("omit") \
+	W("once") \
+	W("one") \
+	W("onion") \
+	W("online") \
+	W("only") \
+	W("open") \
+	W("opera") \
+	W("opinion") \
+	W("oppose") \
+	W("option") \
+	W("orange") \
+	W("orbit") \
+	W("orchard") \
+	W("order") \
+	W("ordinary") \
+	W("organ") \
+	W("orient") \
+	W("original") \
+	W("orphan") \
+	W("ostrich") \
+	W("other") \
+	W("outdoor") \
+	W("outer") \
+	W("output") \
+	W("outside") \
+	W("oval") \
+	W("oven") \
+	W("over") \
+	W("own") \
+	W("owner") \
+	W("oxygen") \
+	W("oyster") \
+	W("ozone") \
+	W("pact") \
+	W("paddle") \
+	W("page") \
+	W("pair") \
+	W("palace") \
+	W("palm") \
+	W("panda") \
+	W("panel") \
+	W("panic") \
+	W("panther") \
+	W("paper") \
+	W("parade") \
+	W("parent") \
+	W("park") \
+	W("parrot") \
+	W("party") \
+	W("pass") \
+	W("patch") \
+	W("path") \
+	W("patient") \
+	W("patrol") \
+	W("pattern") \
+	W("pause") \
+	W("pave") \
+	W("payment") \
+	W("peace") \
+	W("peanut") \
+	W("pear") \
+	W("peasant") \
+	W("pelican") \
+	W("pen") \
+	W("penalty") \
+	W("pencil") \
+	W("people") \
+	W("pepper") \
+	W("perfect") \
+	W("permit") \
+	W("person") \
+	W("pet") \
+	W("phone") \
+	W("photo") \
+	W("phrase") \
+	W("physical") \
+	W("piano") \
+	W("picnic") \
+	W("picture") \
+	W("piece") \
+	W("pig") \
+	W("pigeon") \
+	W("pill") \
+	W("pilot") \
+	W("pink") \
+	W("pioneer") \
+	W("pipe") \
+	W("pistol") \
+	W("pitch") \
+	W("pizza") \
+	W("place") \
+	W("planet") \
+	W("plastic") \
+	W("plate") \
+	W("play") \
+	W("please") \
+	W("pledge") \
+	W("pluck") \
+	W("plug") \
+	W("plunge") \
+	W("poem") \
+	W("poet") \
+	W("point") \
+	W("polar") \
+	W("pole") \
+	W("police") \
+	W("pond") \
+	W("pony") \
+	W("pool") \
+	W("popular") \
+	W("portion") \
+	W("position") \
+	W("possible") \
+	W("post") \
+	W("potato") \
+	W("pottery") \
+	W("poverty") \
+	W("powder") \
+	W("power") \
+	W("practice") \
+	W("praise") \
+	W("predict") \
+	W("prefer") \
+	W("prepare") \
+	W("present") \
+	W("pretty") \
+	W("prevent") \
+	W("price") \
+	W("pride") \
+	W("primary") \
+	W("print") \
+	W("priority") \
+	W("prison") \
+	W("private") \
+	W("prize") \
+	W("problem") \
+	W("process") \
+	W("produce") \
+	W("profit") \
+	W("program") \
+	W("project") \
+	W("promote") \
+	W("proof") \
+	W("property") \
+	W("prosper") \
+	W("protect") \
+	W("proud") \
+	W("provide") \
+	W("public") \
+	W("pudding") \
+	W("pull") \
+	W("pulp") \
+	W("pulse") \
+	W("pumpkin") \
+	W("punch") \
+	W("pupil") \
+	W("puppy") \
+	W("purchase") \
+	W("purity") \
+	W("purpose") \
+	W("purse") \
+	W("push") \
+	W("put") \
+	W("puzzle") \
+	W("pyramid") \
+	W("quality") \
+	W("quantum") \
+	W("quarter") \
+	W("question") \
+	W("quick") \
+	W("quit") \
+	W("quiz") \
+	W("quote") \
+	W("rabbit") \
+	W("raccoon") \
+	W("race") \
+	W("rack") \
+	W("radar") \
+	W("radio") \
+	W("rail") \
+	W("rain") \
+	W("raise") \
+	W("rally") \
+	W("ramp") \
+	W("ranch") \
+	W("random") \
+	W("range") \
+	W("rapid") \
+	W("rare") \
+	W("rate") \
+	W("rather") \
+	W("raven") \
+	W("raw") \
+	W("razor") \
+	W("ready") \
+	W("real") \
+	W("reason") \
+	W("rebel") \
+	W("rebuild") \
+	W("recall") \
+	W("receive") \
+	W("recipe") \
+	W("record") \
+	W("recycle") \
+	W("reduce") \
+	W("reflect") \
+	W("reform") \
+	W("refuse") \
+	W("region") \
+	W("regret") \
+	W("regular") \
+	W("reject") \
+	W("relax") \
+	W("release") \
+	W("relief") \
+	W("rely") \
+	W("remain") \
+	W("remember") \
+	W("remind") \
+	W("remove") \
+	W("render") \
+	W("renew") \
+	W("rent") \
+	W("reopen") \
+	W("repair") \
+	W("repeat") \
+	W("replace") \
+	W("report") \
+	W("require") \
+	W("rescue") \
+	W("resemble") \
+	W("resist") \
+	W("resource") \
+	W("response") \
+	W("result") \
+	W("retire") \
+	W("retreat") \
+	W("return") \
+	W("reunion") \
+	W("reveal") \
+	W("review") \
+	W("reward") \
+	W("rhythm") \
+	W("rib") \
+	W("ribbon") \
+	W("rice") \
+	W("rich") \
+	W("ride") \
+	W("ridge") \
+	W("rifle") \
+	W("right") \
+	W("rigid") \
+	W("ring") \
+	W("riot") \
+	W("ripple") \
+	W("risk") \
+	W("ritual") \
+	W("rival") \
+	W("river") \
+	W("road") \
+	W("roast") \
+	W("robot") \
+	W("robust") \
+	W("rocket") \
+	W("romance") \
+	W("roof") \
+	W("rookie") \
+	W("room") \
+	W("rose") \
+	W("rotate") \
+	W("rough") \
+	W("round") \
+	W("route") \
+	W("royal") \
+	W("rubber") \
+	W("rude") \
+	W("rug") \
+	W("rule") \
+	W("run") \
+	W("runway") \
+	W("rural") \
+	W("sad") \
+	W("saddle") \
+	W("sadness") \
+	W("safe") \
+	W("sail") \
+	W("salad") \
+	W("salmon") \
+	W("salon") \
+	W("salt") \
+	W("salute") \
+	W("same") \
+	W("sample") \
+	W("sand") \
+	W("satisfy") \
+	W("satoshi") \
+	W("sauce") \
+	W("sausage") \
+	W("save") \
+	W("say") \
+	W("scale") \
+	W("scan") \
+	W("scare") \
+	W("scatter") \
+	W("scene") \
+	W("scheme") \
+	W("school") \
+	W("science") \
+	W("scissors") \
+	W("scorpion") \
+	W("scout") \
+	W("scrap") \
+	W("screen") \
+	W("script") \
+	W("scrub") \
+	W("sea") \
+	W("search") \
+	W("season") \
+	W("seat") \
+	W("second") \
+	W("secret") \
+	W("section") \
+	W("security") \
+	W("seed") \
+	W("seek") \
+	W("segment") \
+	W("select") \
+	W("sell") \
+	W("seminar") \
+	W("senior") \
+	W("sense") \
+	W("sentence") \
+	W("series") \
+	W("service") \
+	W("session") \
+	W("settle") \
+	W("setup") \
+	W("seven") \
+	W("shadow") \
+	W("shaft") \
+	W("shallow") \
+	W("share") \
+	W("shed") \
+	W("shell") \
+	W("sheriff") \
+	W("shield") \
+	W("shift") \
+	W("shine") \
+	W("ship") \
+	W("shiver") \
+	W("shock") \
+	W("shoe") \
+	W("shoot") \
+	W("shop") \
+	W("short") \
+	W("shoulder") \
+	W("shove") \
+	W("shrimp") \
+	W("shrug") \
+	W("shuffle") \
+	W("shy") \
+	W("sibling") \
+	W("sick") \
+	W("side") \
+	W("siege") \
+	W("sight") \
+	W("sign") \
+	W("silent") \
+	W("silk") \
+	W("silly") \
+	W("silver") \
+	W("similar") \
+	W("simple") \
+	W("since") \
+	W("sing") \
+	W("siren") \
+	W("sister") \
+	W("situate") \
+	W("six") \
+	W("size") \
+	W("skate") \
+	W("sketch") \
+	W("ski") \
+	W("skill") \
+	W("skin") \
+	W("skirt") \
+	W("skull") \
+	W("slab") \
+	W("slam") \
+	W("sleep") \
+	W("slender") \
+	W("slice") \
+	W("slide") \
+	W("slight") \
+	W("slim") \
+	W("slogan") \
+	W("slot") \
+	W("slow") \
+	W("slush") \
+	W("small") \
+	W("smart") \
+	W("smile") \
+	W("smoke") \
+	W("smooth") \
+	W("snack") \
+	W("snake") \
+	W("snap") \
+	W("sniff") \
+	W("snow") \
+	W("soap") \
+	W("soccer") \
+	W("social") \
+	W("sock") \
+	W("soda") \
+	W("soft") \
+	W("solar") \
+	W("soldier") \
+	W("solid") \
+	W("solution") \
+	W("solve") \
+	W("someone") \
+	W("song") \
+	W("soon") \
+	W("sorry") \
+	W("sort") \
+	W("soul") \
+	W("sound") \
+	W("soup") \
+	W("source") \
+	W("south") \
+	W("space") \
+	W("spare") \
+	W("spatial") \
+	W("spawn") \
+	W("speak") \
+	W("special") \
+	W("speed") \
+	W("spell") \
+	W("spend") \
+	W("sphere") \
+	W("spice") \
+	W("spider") \
+	W("spike") \
+	W("spin") \
+	W("spirit") \
+	W("split") \
+	W("spoil") \
+	W("sponsor") \
+	W("spoon") \
+	W("sport") \
+	W("spot") \
+	W("spray") \
+	W("spread") \
+	W("spring") \
+	W("spy") \
+	W("square") \
+	W("squeeze") \
+	W("squirrel") \
+	W("stable") \
+	W("stadium") \
+	W("staff") \
+	W("stage") \
+	W("stairs") \
+	W("stamp") \
+	W("stand") \
+	W("start") \
+	W("state") \
+	W("stay") \
+	W("steak") \
+	W("steel") \
+	W("stem") \
+	W("step") \
+	W("stereo") \
+	W("stick") \
+	W("still") \
+	W("sting") \
+	W("stock") \
+	W("stomach") \
+	W("stone") \
+	W("stool") \
+	W("story") \
+	W("stove") \
+	W("strategy") \
+	W("street") \
+	W("strike") \
+	W("strong") \
+	W("struggle") \
+	W("student") \
+	W("stuff") \
+	W("stumble") \
+	W("style") \
+	W("subject") \
+	W("submit") \
+	W("subway") \
+	W("success") \
+	W("such") \
+	W("sudden") \
+	W("suffer") \
+	W("sugar") \
+	W("suggest") \
+	W("suit") \
+	W("summer") \
+	W("sun") \
+	W("sunny") \
+	W("sunset") \
+	W("super") \
+	W("supply") \
+	W("supreme") \
+	W("sure") \
+	W("surface") \
+	W("surge") \
+	W("surprise") \
+	W("surround") \
+	W("survey") \
+	W("suspect") \
+	W("sustain") \
+	W("swallow") \
+	W("swamp") \
+	W("swap") \
+	W("swarm") \
+	W("swear") \
+	W("sweet") \
+	W("swift") \
+	W("swim") \
+	W("swing") \
+	W("switch") \
+	W("sword") \
+	W("symbol") \
+	W("symptom") \
+	W("syrup") \
+	W("system") \
+	W("table") \
+	W("tackle") \
+	W("tag") \
+	W("tail") \
+	W("talent") \
+	W("talk") \
+	W("tank") \
+	W("tape") \
+	W("target") \
+	W("task") \
+	W("taste") \
+	W("tattoo") \
+	W("taxi") \
+	W("teach") \
+	W("team") \
+	W("tell") \
+	W("ten") \
+	W("tenant") \
+	W("tennis") \
+	W("tent") \
+	W("term") \
+	W("test") \
+	W("text") \
+	W("thank") \
+	W("that") \
+	W("theme") \
+	W("then") \
+	W("theory") \
+	W("there") \
+	W("they") \
+	W("thing") \
+	W("this") \
+	W("thought") \
+	W("three") \
+	W("thrive") \
+	W("throw") \
+	W("thumb") \
+	W("thunder") \
+	W("ticket") \
+	W("tide") \
+	W("tiger") \
+	W("tilt") \
+	W("timber") \
+	W("time") \
+	W("tiny") \
+	W("tip") \
+	W("tired") \
+	W("tissue") \
+	W("title") \
+	W("toast") \
+	W("tobacco") \
+	W("today") \
+	W("toddler") \
+	W("toe") \
+	W("together") \
+	W("toilet") \
+	W("token") \
+	W("tomato") \
+	W("tomorrow") \
+	W("tone") \
+	W("tongue") \
+	W("tonight") \
+	W("tool") \
+	W("tooth") \
+	W("top") \
+	W("topic") \
+	W("topple") \
+	W("torch") \
+	W("tornado") \
+	W("tortoise") \
+	W("toss") \
+	W("total") \
+	W("tourist") \
+	W("toward") \
+	W("tower") \
+	W("town") \
+	W("toy") \
+	W("track") \
+	W("trade") \
+	W("traffic") \
+	W("tragic") \
+	W("train") \
+	W("transfer") \
+	W("trap") \
+	W("trash") \
+	W("travel") \
+	W("tray") \
+	W("treat") \
+	W("tree") \
+	W("trend") \
+	W("trial") \
+	W("tribe") \
+	W("trick") \
+	W("trigger") \
+	W("trim") \
+	W("trip") \
+	W("trophy") \
+	W("trouble") \
+	W("truck") \
+	W("true") \
+	W("truly") \
+	W("trumpet") \
+	W("trust") \
+	W("truth") \
+	W("try") \
+	W("tube") \
+	W("tuition") \
+	W("tumble") \
+	W("tuna") \
+	W("tunnel") \
+	W("turkey") \
+	W("turn") \
+	W("turtle") \
+	W("twelve") \
+	W("twenty") \
+	W("twice") \
+	W("twin") \
+	W("twist") \
+	W("two") \
+	W("type") \
+	W("typical") \
+	W("ugly") \
+	W("umbrella") \
+	W("unable") \
+	W("unaware") \
+	W("uncle") \
+	W("uncover") \
+	W("under") \
+	W("undo") \
+	W("unfair") \
+	W("unfold") \
+	W("unhappy") \
+	W("uniform") \
+	W("unique") \
+	W("unit") \
+	W("universe") \
+	W("unknown") \
+	W("unlock") \
+	W("until") \
+	W("unusual") \
+	W("unveil") \
+	W("update") \
+	W("upgrade") \
+	W("uphold") \
+	W("upon") \
+	W("upper") \
+	W("upset") \
+	W("urban") \
+	W("urge") \
+	W("usage") \
+	W("use") \
+	W("used") \
+	W("useful") \
+	W("useless") \
+	W("usual") \
+	W("utility") \
+	W("vacant") \
+	W("vacuum") \
+	W("vague") \
+	W("valid") \
+	W("valley") \
+	W("valve") \
+	W("van") \
+	W("vanish") \
+	W("vapor") \
+	W("various") \
+	W("vast") \
+	W("vault") \
+	W("vehicle") \
+	W("velvet") \
+	W("vendor") \
+	W("venture") \
+	W("venue") \
+	W("verb") \
+	W("verify") \
+	W("version") \
+	W("very") \
+	W("vessel") \
+	W("veteran") \
+	W("viable") \
+	W("vibrant") \
+	W("vicious") \
+	W("victory") \
+	W("video") \
+	W("view") \
+	W("village") \
+	W("vintage") \
+	W("violin") \
+	W("virtual") \
+	W("virus") \
+	W("visa") \
+	W("visit") \
+	W("visual") \
+	W("vital") \
+	W("vivid") \
+	W("vocal") \
+	W("voice") \
+	W("void") \
+	W("volcano") \
+	W("volume") \
+	W("vote") \
+	W("voyage") \
+	W("wage") \
+	W("wagon") \
+	W("wait") \
+	W("walk") \
+	W("wall") \
+	W("walnut") \
+	W("want") \
+	W("warfare") \
+	W("warm") \
+	W("warrior") \
+	W("wash") \
+	W("wasp") \
+	W("waste") \
+	W("water") \
+	W("wave") \
+	W("way") \
+	W("wealth") \
+	W("weapon") \
+	W("wear") \
+	W("weasel") \
+	W("weather") \
+	W("web") \
+	W("wedding") \
+	W("weekend") \
+	W("weird") \
+	W("welcome") \
+	W("west") \
+	W("wet") \
+	W("whale") \
+	W("what") \
+	W("wheat") \
+	W("wheel") \
+	W("when") \
+	W("where") \
+	W("whip") \
+	W("whisper") \
+	W("wide") \
+	W("width") \
+	W("wife") \
+	W("wild") \
+	W("will") \
+	W("win") \
+	W("window") \
+	W("wine") \
+	W("wing") \
+	W("wink") \
+	W("winner") \
+	W("winter") \
+	W("wire") \
+	W("wisdom") \
+	W("wise") \
+	W("wish") \
+	W("witness") \
+	W("wolf") \
+	W("woman") \
+	W("wonder") \
+	W("wood") \
+	W("wool") \
+	W("word") \
+	W("work") \
+	W("world") \
+	W("worry") \
+	W("worth") \
+	W("wrap") \
+	W("wreck") \
+	W("wrestle") \
+	W("wrist") \
+	W("write") \
+	W("wrong") \
+	W("yard") \
+	W("year") \
+	W("yellow") \
+	W("you") \
+	W("young") \
+	W("youth") \
+	W("zebra") \
+	W("zero") \
+	W("zone") \
+	W("zoo") \
+
+// a longer word would be truncated silently
+#define WORDLIST_CHECK(word) _Static_assert(sizeof(word) - 1 <= WORD_LEN_MAX, "too long: " word);
+WORDLIST(WORDLIST_CHECK)
+#undef WORDLIST_CHECK
+
+/* the rows are not NUL terminated, words shorter than WORD_LEN_MAX are padded
+ * with NULs. They are initialized character by character since a string
+ * literal filling a whole row is warned about as unterminated. */
+_Static_assert(WORD_LEN_MAX == 8, "WORDLIST_ROW emits WORD_LEN_MAX characters");
+#define WORDLIST_CHAR(word, i) ((i) < sizeof(word) - 1 ? (word)[i] : 0)
+#define WORDLIST_ROW(word) { \
+	WORDLIST_CHAR(word, 0), WORDLIST_CHAR(word, 1), WORDLIST_CHAR(word, 2), WORDLIST_CHAR(word, 3), \
+	WORDLIST_CHAR(word, 4), WORDLIST_CHAR(word, 5), WORDLIST_CHAR(word, 6), WORDLIST_CHAR(word, 7) },
+static const char wordlist[1 << BITS_PER_WORD][WORD_LEN_MAX] = {
+	WORDLIST(WORDLIST_ROW)
+};
+#undef WORDLIST_ROW
+#undef WORDLIST_CHAR
+
+#define WORDLIST_LEN(word) sizeof(word) - 1,
+static const uint8_t wordlist_len[1 << BITS_PER_WORD] = {
+	WORDLIST(WORDLIST_LEN)
 };
+#undef WORDLIST_LEN
@@ -0,0 +1,201 @@
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "cpu.h"
+#include "tweetnacl.h"
+#include "x25519.h"
+
+#if defined(HAVE_FE51)
+#define crypto_scalarmult_portable crypto_scalarmult_fe51
+#elif defined(HAVE_FE25)
+#define crypto_scalarmult_portable crypto_scalarmult_fe25
+#else
+#define crypto_scalarmult_portable crypto_scalarmult_ref
+#endif
+
+typedef int scalarmult_fn(uint8_t *q, const uint8_t *n, const uint8_t *p);
+
+// selected by x25519_dispatch, or for the CPU on first use, the single ladder
+// and the batches separately so that each process only checks what it uses
+static scalarmult_fn *scalarmult_impl = crypto_scalarmult_portable;
+static pthread_once_t scalarmult_once = PTHREAD_ONCE_INIT;
+static bool batch_avx2;
+static pthread_once_t batch_once = PTHREAD_ONCE_INIT;
+
+static int select_scalarmult(unsigned int cpu);
+static int select_batch(unsigned int cpu);
+
+static void scalarmult_load(void)
+{
+	select_scalarmult(cpu_features());
+}
+
+static void batch_load(void)
+{
+	select_batch(cpu_features());
+}
+
+int crypto_scalarmult(unsigned char *q, const unsigned char *n, const unsigned char *p)
+{
+	pthread_once(&scalarmult_once, scalarmult_load);
+	return scalarmult_impl(q, n, p);
+}
+
+int crypto_scalarmult_base(unsigned char *q, const unsigned char *n)
+{
+#if defined(HAVE_FE51) && defined(HAVE_BASE_TABLE)
+	return crypto_scalarmult_base_fe51(q, n);
+#else
+	static const uint8_t basepoint[32] = {9};
+
+	return crypto_scalarmult(q, n, basepoint);
+#endif
+}
+
+int crypto_scalarmult_batch(unsigned char *q, const unsigned char *n, const unsigned char *p, size_t count)
+{
+#ifdef HAVE_AVX2
+	pthread_once(&batch_once, batch_load);
+
+	if (batch_avx2 && count >= 4) {
+		size_t groups = count / 4;
+
+		crypto_scalarmult_avx2x4(q, n, p, groups);
+		q += 4 * 32 * groups;
+		p += 4 * 32 * groups;
+		count -= 4 * groups;
+	}
+#endif
+
+#ifdef HAVE_FE51
+	return crypto_scalarmult_batch_fe51(q, n, p, count);
+#else
+	for (; count; count--) {
+		crypto_scalarmult(q, n, p);
+		q += 32;
+		p += 32;
+	}
+
+	return 0;
+#endif
+}
+
+int crypto_scalarmult_table_init(void *table, const unsigned char *p)
+{
+#ifdef HAVE_FE51
+	return x25519_table_init_fe51(table, p);
+#else
+	return -1;
+#endif
+}
+
+int crypto_scalarmult_table(unsigned char *q, const unsigned char *n, const void *table)
+{
+#ifdef HAVE_FE51
+	return crypto_scalarmult_table_fe51(q, n, table);
+#else
+	return -1;
+#endif
+}
+
+int crypto_scalarmult_base_pair(unsigned char *q_base, unsigned char *q,
+                                const unsigned char *n, const unsigned char *p, const void *p_table)
+{
+#ifdef HAVE_FE51
+	return crypto_scalarmult_base_pair_fe51(q_base, q, n, p, p_table);
+#else
+	crypto_scalarmult_base(q_base, n);
+	return crypto_scalarmult(q, n, p);
+#endif
+}
+
+// RFC7748, Section 5.2
+static const uint8_t kat_scalar[32] = {
+	0xa5, 0x46, 0xe3, 0x6b, 0xf0, 0x52, 0x7c, 0x9d, 0x3b, 0x16, 0x15, 0x4b, 0x82, 0x46, 0x5e, 0xdd,
+	0x62, 0x14, 0x4c, 0x0a, 0xc1, 0xfc, 0x5a, 0x18, 0x50, 0x6a, 0x22, 0x44, 0xba, 0x44, 0x9a, 0xc4
+};
+static const uint8_t kat_u[32] = {
+	0xe6, 0xdb, 0x68, 0x67, 0x58, 0x30, 0x30, 0xdb, 0x35, 0x94, 0xc1, 0xa4, 0x24, 0xb1, 0x5f, 0x7c,
+	0x72, 0x66, 0x24, 0xec, 0x26, 0xb3, 0x35, 0x3b, 0x10, 0xa9, 0x03, 0xa6, 0xd0, 0xab, 0x1c, 0x4c
+};
+static const uint8_t kat_expected[32] = {
+	0xc3, 0xda, 0x55, 0x37, 0x9d, 0xe9, 0xc6, 0x90, 0x8e, 0x94, 0xea, 0x4d, 0xf2, 0x8d, 0x08, 0x4f,
+	0x32, 0xec, 0xcf, 0x03, 0x49, 0x1c, 0x71, 0xf7, 0x54, 0xb4, 0x07, 0x55, 0x77, 0xa2, 0x85, 0x52
+};
+
+static int scalarmult_selftest(scalarmult_fn *scalarmult)
+{
+	uint8_t out[32];
+
+	scalarmult(out, kat_scalar, kat_u);
+
+	return memcmp(out, kat_expected, sizeof(out)) == 0 ? 0 : -1;
+}
+
+/* the candidates are called directly, only the selected one is checked and
+ * the portable code is used if that fails */
+static int select_scalarmult(unsigned int cpu)
+{
+	scalarmult_fn *select = crypto_scalarmult_portable;
+
+#ifdef HAVE_MULX
+	if (cpu & CPU_BMI2_ADX)
+		select = crypto_scalarmult_mulx;
+#endif
+
+	if (scalarmult_selftest(select) != 0) {
+		scalarmult_impl = crypto_scalarmult_portable;
+		return -1;
+	}
+
+	scalarmult_impl = select;
+	return 0;
+}
+
+/* only the AVX2 ladder is checked, batches don't use it if that fails */
+static int select_batch(unsigned int cpu)
+{
+	batch_avx2 = false;
+
+#ifdef HAVE_AVX2
+	if (cpu & CPU_AVX2) {
+		uint8_t points[4 * 32], out[4 * 32];
+
+		for (int k = 0; k < 4; k++)
+			memcpy(points + 32 * k, kat_u, 32);
+
+		crypto_scalarmult_avx2x4(out, kat_scalar, points, 1);
+
+		for (int k = 0; k < 4; k++) {
+			if (memcmp(out + 32 * k, kat_expected, 32) != 0)
+				return -1;
+		}
+
+		batch_avx2 = true;
+	}
+#else
+	(void)cpu;
+#endif
+
+	return 0;
+}
+
+int x25519_dispatch(unsigned int cpu)
+{
+	int ret = 0;
+
+	// the first use would undo this otherwise
+	pthread_once(&scalarmult_once, scalarmult_load);
+	pthread_once(&batch_once, batch_load);
+
+	if (select_scalarmult(cpu) < 0)
+		ret = -1;
+
+	if (select_batch(cpu) < 0)
+		ret = -1;
+
+	return ret;
+}
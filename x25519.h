@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// field arithmetic backends behind crypto_scalarmult, see x25519.c
+
+// selects the backends for the given CPU features (see cpu.h) and checks them
+// against known answers. This happens for cpu_features() on first use,
+// calling it explicitly (e.g. in tests) must not race with scalar
+// multiplications in other threads.
+//
+// Returns -1 if a self-test failed.
+int x25519_dispatch(unsigned int cpu);
+
+int crypto_scalarmult_ref(uint8_t *q, const uint8_t *n, const uint8_t *p);
+
+// out = in^-1 mod p for in < p (0 for 0), out and in may alias
+void x25519_invert_fermat(uint8_t *out, const uint8_t *in);
+void x25519_invert_safegcd(uint8_t out[32], const uint8_t in[32]);
+
+#ifdef HAVE_FE51
+int crypto_scalarmult_fe51(uint8_t *q, const uint8_t *n, const uint8_t *p);
+int crypto_scalarmult_batch_fe51(uint8_t *q, const uint8_t *n, const uint8_t *p, size_t count);
+int x25519_table_init_fe51(uint64_t (*table)[8][3][5], const uint8_t *p);
+int crypto_scalarmult_table_fe51(uint8_t *q, const uint8_t *n, const uint64_t (*table)[8][3][5]);
+int crypto_scalarmult_base_pair_fe51(uint8_t *q_base, uint8_t *q, const uint8_t *n, const uint8_t *p,
+                                     const uint64_t (*p_table)[8][3][5]);
+#ifdef HAVE_BASE_TABLE
+int crypto_scalarmult_base_fe51(uint8_t *q, const uint8_t *n);
+#endif
+#endif
+
+#ifdef HAVE_FE25
+int crypto_scalarmult_fe25(uint8_t *q, const uint8_t *n, const uint8_t *p);
+#endif
+
+#ifdef HAVE_AVX2
+// needs CPU_AVX2, q and p hold four points per group
+int crypto_scalarmult_avx2x4(uint8_t *q, const uint8_t *n, const uint8_t *p, size_t groups);
+#endif
+
+#ifdef HAVE_MULX
+// needs CPU_BMI2_ADX
+int crypto_scalarmult_mulx(uint8_t *q, const uint8_t *n, const uint8_t *p);
+#endif
@@ -0,0 +1,296 @@
+// X25519 on a radix-2^25.5 field representation
+//
+// Field elements are stored as ten signed limbs of alternating 26 and 25 bits
+// in int32_t, products are accumulated in int64_t, which is what 32 bit cores
+// handle natively (as opposed to the 64 bit limbs in tweetnacl.c). This
+// follows the ref10 implementation by Bernstein et al.: additions and
+// subtractions do not carry, and the ladder is ordered such that limbs never
+// exceed 1.65 * 2^26 before a multiplication, so that 19 times a limb fits
+// into int32_t and sums of products into int64_t.
+//
+// This is built on targets with 32 bit pointers (HAVE_FE25), where the
+// radix-2^51 backend is not available.
+
+#include <stdint.h>
+#include <string.h>
+
+#include "utils.h"
+
+#include "x25519.h"
+
+typedef int32_t fe25[10];
+
+static const uint8_t limb_bits[10] = { 26, 25, 26, 25, 26, 25, 26, 25, 26, 25 };
+static const uint8_t limb_start[10] = { 0, 26, 51, 77, 102, 128, 153, 179, 204, 230 };
+
+static void fe25_frombytes(fe25 h, const uint8_t *s)
+{
+	uint8_t buf[40] = {0};
+	memcpy(buf, s, 32);
+	buf[31] &= 127;
+
+	for (int i = 0; i < 10; i++) {
+		uint64_t w = unp64le(buf + limb_start[i] / 8);
+		h[i] = (w >> (limb_start[i] % 8)) & ((UINT64_C(1) << limb_bits[i]) - 1);
+	}
+}
+
+static void fe25_tobytes(uint8_t *s, const fe25 in)
+{
+	int32_t h[10];
+	memcpy(h, in, sizeof(h));
+
+	// q = 1 iff h >= p, i.e. iff h + 19 overflows 2^255 (h is within
+	// (-2^255, 2^256) here, so the rounding in q is exact)
+	int32_t q = (19 * h[9] + (1 << 24)) >> 25;
+	for (int i = 0; i < 10; i++)
+		q = (h[i] + q) >> limb_bits[i];
+
+	h[0] += 19 * q;
+	for (int i = 0; i < 9; i++) {
+		int32_t carry = h[i] >> limb_bits[i];
+
+		h[i+1] += carry;
+		h[i] -= carry * ((int32_t)1 << limb_bits[i]);
+	}
+	h[9] &= (1 << 25) - 1;
+
+	uint64_t acc = 0;
+	unsigned int acc_bits = 0, j = 0;
+	for (int i = 0; i < 10; i++) {
+		acc |= (uint64_t)(uint32_t)h[i] << acc_bits;
+		acc_bits += limb_bits[i];
+
+		while (acc_bits >= 8) {
+			s[j++] = acc & 0xff;
+			acc >>= 8;
+			acc_bits -= 8;
+		}
+	}
+	s[j] = acc;
+}
+
+static void fe25_add(fe25 o, const fe25 a, const fe25 b)
+{
+	for (int i = 0; i < 10; i++)
+		o[i] = a[i] + b[i];
+}
+
+static void fe25_sub(fe25 o, const fe25 a, const fe25 b)
+{
+	for (int i = 0; i < 10; i++)
+		o[i] = a[i] - b[i];
+}
+
+/* Carries h into o with rounding carries (limbs end up in [-2^25, 2^25]
+ * and [-2^24, 2^24]), interleaving two chains as ref10 does */
+static void fe25_carry(fe25 o, int64_t h[10])
+{
+	static const uint8_t order[] = { 0, 4, 1, 5, 2, 6, 3, 7, 4, 8, 9, 0 };
+
+#pragma GCC unroll 12
+	for (size_t k = 0; k < ARRAY_SIZE(order); k++) {
+		int i = order[k];
+		int bits = limb_bits[i];
+		int64_t carry = (h[i] + ((int64_t)1 << (bits - 1))) >> bits;
+
+		if (i == 9)
+			h[0] += carry * 19;
+		else
+			h[i+1] += carry;
+
+		h[i] -= carry * ((int64_t)1 << bits);
+	}
+
+	for (int i = 0; i < 10; i++)
+		o[i] = (int32_t)h[i];
+}
+
+static void fe25_mul(fe25 o, const fe25 f, const fe25 g)
+{
+	int32_t f2[10], g19[10];
+	int64_t h[10] = {0};
+
+	for (int i = 0; i < 10; i++) {
+		f2[i] = 2 * f[i];
+		g19[i] = 19 * g[i];
+	}
+
+	// products of two odd limbs carry an extra factor of two, products
+	// wrapping around 2^255 an extra factor of 19
+#pragma GCC unroll 10
+	for (int i = 0; i < 10; i++) {
+#pragma GCC unroll 10
+		for (int j = 0; j < 10; j++) {
+			int32_t a = (i & j & 1) ? f2[i] : f[i];
+
+			if (i + j < 10)
+				h[i+j] += (int64_t)a * g[j];
+			else
+				h[i+j-10] += (int64_t)a * g19[j];
+		}
+	}
+
+	fe25_carry(o, h);
+}
+
+static void fe25_sq(fe25 o, const fe25 f)
+{
+	int32_t f2[10], f4[10], f19[10];
+	int64_t h[10] = {0};
+
+	for (int i = 0; i < 10; i++) {
+		f2[i] = 2 * f[i];
+		f4[i] = 4 * f[i];
+		f19[i] = 19 * f[i];
+	}
+
+	// as in fe25_mul, with the products f_i f_j and f_j f_i combined
+#pragma GCC unroll 10
+	for (int i = 0; i < 10; i++) {
+#pragma GCC unroll 10
+		for (int j = i; j < 10; j++) {
+			int32_t a;
+
+			if (i == j)
+				a = (i & 1) ? f2[i] : f[i];
+			else
+				a = (i & j & 1) ? f4[i] : f2[i];
+
+			if (i + j < 10)
+				h[i+j] += (int64_t)a * f[j];
+			else
+				h[i+j-10] += (int64_t)a * f19[j];
+		}
+	}
+
+	fe25_carry(o, h);
+}
+
+static void fe25_mul_121666(fe25 o, const fe25 f)
+{
+	int64_t h[10];
+
+	for (int i = 0; i < 10; i++)
+		h[i] = (int64_t)f[i] * 121666;
+
+	fe25_carry(o, h);
+}
+
+static void fe25_cswap(fe25 a, fe25 b, uint32_t swap)
+{
+	int32_t mask = -(int32_t)swap;
+
+	for (int i = 0; i < 10; i++) {
+		int32_t t = mask & (a[i] ^ b[i]);
+		a[i] ^= t;
+		b[i] ^= t;
+	}
+}
+
+#ifndef HAVE_SAFEGCD
+static void fe25_sq_n(fe25 o, const fe25 a, int n)
+{
+	fe25_sq(o, a);
+	while (--n)
+		fe25_sq(o, o);
+}
+#endif
+
+/* a^(p-2), see fe51_invert */
+static void fe25_invert(fe25 o, const fe25 z)
+{
+#ifdef HAVE_SAFEGCD
+	uint8_t b[32];
+
+	fe25_tobytes(b, z);
+	x25519_invert_safegcd(b, b);
+	fe25_frombytes(o, b);
+#else
+	fe25 z2, z9, z11, z2_5_0, z2_10_0, z2_20_0, z2_50_0, z2_100_0, t;
+
+	fe25_sq(z2, z);
+	fe25_sq_n(t, z2, 2);
+	fe25_mul(z9, t, z);
+	fe25_mul(z11, z9, z2);
+	fe25_sq(t, z11);
+	fe25_mul(z2_5_0, t, z9);
+	fe25_sq_n(t, z2_5_0, 5);
+	fe25_mul(z2_10_0, t, z2_5_0);
+	fe25_sq_n(t, z2_10_0, 10);
+	fe25_mul(z2_20_0, t, z2_10_0);
+	fe25_sq_n(t, z2_20_0, 20);
+	fe25_mul(t, t, z2_20_0);
+	fe25_sq_n(t, t, 10);
+	fe25_mul(z2_50_0, t, z2_10_0);
+	fe25_sq_n(t, z2_50_0, 50);
+	fe25_mul(z2_100_0, t, z2_50_0);
+	fe25_sq_n(t, z2_100_0, 100);
+	fe25_mul(t, t, z2_100_0);
+	fe25_sq_n(t, t, 50);
+	fe25_mul(t, t, z2_50_0);
+	fe25_sq_n(t, t, 5);
+	fe25_mul(o, t, z11);
+#endif
+}
+
+/* Montgomery ladder, RFC7748 Section 5, with the operations in the order of
+ * ref10 to stay within its limb bounds */
+int crypto_scalarmult_fe25(uint8_t *q, const uint8_t *n, const uint8_t *p)
+{
+	uint8_t e[32];
+	memcpy(e, n, 32);
+	e[0] &= 248;
+	e[31] = (e[31] & 127) | 64;
+
+	fe25 x1, x2 = {1}, z2 = {0}, x3, z3 = {1}, tmp0, tmp1;
+
+	fe25_frombytes(x1, p);
+	memcpy(x3, x1, sizeof(x3));
+
+	uint32_t swap = 0;
+	for (int i = 254; i >= 0; i--) {
+		uint32_t bit = (e[i >> 3] >> (i & 7)) & 1;
+
+		swap ^= bit;
+		fe25_cswap(x2, x3, swap);
+		fe25_cswap(z2, z3, swap);
+		swap = bit;
+
+		fe25_sub(tmp0, x3, z3);       // D
+		fe25_sub(tmp1, x2, z2);       // B
+		fe25_add(x2, x2, z2);         // A
+		fe25_add(z2, x3, z3);         // C
+		fe25_mul(z3, tmp0, x2);       // DA
+		fe25_mul(z2, z2, tmp1);       // CB
+		fe25_sq(tmp0, tmp1);          // BB
+		fe25_sq(tmp1, x2);            // AA
+		fe25_add(x3, z3, z2);
+		fe25_sub(z2, z3, z2);
+		fe25_mul(x2, tmp1, tmp0);     // AA * BB
+		fe25_sub(tmp1, tmp1, tmp0);   // E = AA - BB
+		fe25_sq(z2, z2);
+		fe25_mul_121666(z3, tmp1);
+		fe25_sq(x3, x3);
+		fe25_add(tmp0, tmp0, z3);     // BB + 121666 E = AA + 121665 E
+		fe25_mul(z3, x1, z2);
+		fe25_mul(z2, tmp1, tmp0);
+	}
+
+	fe25_cswap(x2, x3, swap);
+	fe25_cswap(z2, z3, swap);
+
+	fe25_invert(z2, z2);
+	fe25_mul(x2, x2, z2);
+	fe25_tobytes(q, x2);
+
+	wipe_sized(e);
+	wipe_sized(x2);
+	wipe_sized(z2);
+	wipe_sized(x3);
+	wipe_sized(z3);
+	wipe_sized(tmp0);
+	wipe_sized(tmp1);
+
+	return 0;
+}
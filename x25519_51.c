@@ -0,0 +1,864 @@
+// X25519 on a radix-2^51 field representation
+//
+// Field elements are stored as five 51 bit limbs in uint64_t, products are
+// accumulated in unsigned __int128. Additions and subtractions do not carry,
+// only multiplications and squarings normalize their result, so every
+// operand fed into fe51_mul/fe51_sq has limbs below 2^54.
+//
+// This is only built if the compiler supports 128 bit integers (HAVE_FE51),
+// crypto_scalarmult_ref in tweetnacl.c is the portable fallback.
+//
+// Multiplications with fixed points are done on the birationally equivalent
+// Edwards curve using signed 4 bit windows over a table of precomputed
+// multiples, in the way ref10 does for Ed25519. For the base point
+// (HAVE_BASE_TABLE), that table is generated by gen_base_table.py, for other
+// points x25519_table_init_fe51 computes it at runtime.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "utils.h"
+
+#include "x25519.h"
+
+#ifdef HAVE_BASE_TABLE
+#include "ge25519_base_table_fe51.h"
+#endif
+
+typedef unsigned __int128 u128;
+typedef uint64_t fe51[5];
+
+#define MASK51 ((UINT64_C(1) << 51) - 1)
+
+// number of ladders interleaved and normalized together by
+// crypto_scalarmult_batch_fe51
+#define LADDER_BATCH 8
+
+static void fe51_frombytes(fe51 out, const uint8_t in[static 32])
+{
+	out[0] = unp64le(in +  0)        & MASK51;
+	out[1] = (unp64le(in +  6) >> 3)  & MASK51;
+	out[2] = (unp64le(in + 12) >> 6)  & MASK51;
+	out[3] = (unp64le(in + 19) >> 1)  & MASK51;
+	out[4] = (unp64le(in + 24) >> 12) & MASK51;
+}
+
+static void fe51_carry(fe51 t)
+{
+	for (int i = 0; i < 4; i++) {
+		t[i+1] += t[i] >> 51;
+		t[i] &= MASK51;
+	}
+
+	t[0] += 19 * (t[4] >> 51);
+	t[4] &= MASK51;
+}
+
+static void fe51_tobytes(uint8_t out[static 32], const fe51 a)
+{
+	uint64_t t[5] = { a[0], a[1], a[2], a[3], a[4] };
+
+	fe51_carry(t);
+	fe51_carry(t);
+
+	/* t is now below 2^255 + 19, so it needs to be reduced by p at most
+	 * once. q = 1 iff t + 19 overflows 2^255, i.e. iff t >= p */
+	uint64_t q = (t[0] + 19) >> 51;
+	for (int i = 1; i < 5; i++)
+		q = (t[i] + q) >> 51;
+
+	t[0] += 19 * q;
+	for (int i = 0; i < 4; i++) {
+		t[i+1] += t[i] >> 51;
+		t[i] &= MASK51;
+	}
+	t[4] &= MASK51;
+
+	uint64_t w[4] = {
+		t[0]         | (t[1] << 51),
+		(t[1] >> 13) | (t[2] << 38),
+		(t[2] >> 26) | (t[3] << 25),
+		(t[3] >> 39) | (t[4] << 12),
+	};
+
+	for (int i = 0; i < 4; i++)
+		for (int j = 0; j < 8; j++)
+			out[8*i + j] = w[i] >> (8*j);
+}
+
+static void fe51_add(fe51 o, const fe51 a, const fe51 b)
+{
+	for (int i = 0; i < 5; i++)
+		o[i] = a[i] + b[i];
+}
+
+/* adds 4p before subtracting so no limb can underflow as long as b has been
+ * normalized by a preceding multiplication */
+static void fe51_sub(fe51 o, const fe51 a, const fe51 b)
+{
+	o[0] = (a[0] + UINT64_C(0x1fffffffffffb4)) - b[0];
+	o[1] = (a[1] + UINT64_C(0x1ffffffffffffc)) - b[1];
+	o[2] = (a[2] + UINT64_C(0x1ffffffffffffc)) - b[2];
+	o[3] = (a[3] + UINT64_C(0x1ffffffffffffc)) - b[3];
+	o[4] = (a[4] + UINT64_C(0x1ffffffffffffc)) - b[4];
+}
+
+static void fe51_reduce(fe51 o, u128 r[5])
+{
+	for (int i = 0; i < 4; i++) {
+		r[i+1] += (uint64_t)(r[i] >> 51);
+		r[i] = (uint64_t)r[i] & MASK51;
+	}
+
+	/* r[4] >> 51 can be up to 2^63, so the fold into r[0] needs to be done
+	 * in 128 bits as well */
+	r[0] += (u128)(uint64_t)(r[4] >> 51) * 19;
+	r[4] = (uint64_t)r[4] & MASK51;
+
+	r[1] += (uint64_t)(r[0] >> 51);
+	r[0] = (uint64_t)r[0] & MASK51;
+
+	for (int i = 0; i < 5; i++)
+		o[i] = (uint64_t)r[i];
+}
+
+static void fe51_mul(fe51 o, const fe51 a, const fe51 b)
+{
+	uint64_t b1_19 = 19 * b[1];
+	uint64_t b2_19 = 19 * b[2];
+	uint64_t b3_19 = 19 * b[3];
+	uint64_t b4_19 = 19 * b[4];
+
+	u128 r[5];
+	r[0] = (u128)a[0] * b[0] + (u128)a[1] * b4_19 + (u128)a[2] * b3_19 + (u128)a[3] * b2_19 + (u128)a[4] * b1_19;
+	r[1] = (u128)a[0] * b[1] + (u128)a[1] * b[0]  + (u128)a[2] * b4_19 + (u128)a[3] * b3_19 + (u128)a[4] * b2_19;
+	r[2] = (u128)a[0] * b[2] + (u128)a[1] * b[1]  + (u128)a[2] * b[0]  + (u128)a[3] * b4_19 + (u128)a[4] * b3_19;
+	r[3] = (u128)a[0] * b[3] + (u128)a[1] * b[2]  + (u128)a[2] * b[1]  + (u128)a[3] * b[0]  + (u128)a[4] * b4_19;
+	r[4] = (u128)a[0] * b[4] + (u128)a[1] * b[3]  + (u128)a[2] * b[2]  + (u128)a[3] * b[1]  + (u128)a[4] * b[0];
+
+	fe51_reduce(o, r);
+}
+
+static void fe51_sq(fe51 o, const fe51 a)
+{
+	uint64_t a0_2 = 2 * a[0];
+	uint64_t a1_2 = 2 * a[1];
+	uint64_t a1_38 = 38 * a[1];
+	uint64_t a2_38 = 38 * a[2];
+	uint64_t a3_38 = 38 * a[3];
+	uint64_t a3_19 = 19 * a[3];
+	uint64_t a4_19 = 19 * a[4];
+
+	u128 r[5];
+	r[0] = (u128)a[0] * a[0] + (u128)a1_38 * a[4] + (u128)a2_38 * a[3];
+	r[1] = (u128)a0_2 * a[1] + (u128)a2_38 * a[4] + (u128)a3_19 * a[3];
+	r[2] = (u128)a0_2 * a[2] + (u128)a[1] * a[1]  + (u128)a3_38 * a[4];
+	r[3] = (u128)a0_2 * a[3] + (u128)a1_2 * a[2]  + (u128)a4_19 * a[4];
+	r[4] = (u128)a0_2 * a[4] + (u128)a1_2 * a[3]  + (u128)a[2] * a[2];
+
+	fe51_reduce(o, r);
+}
+
+static void fe51_sq_n(fe51 o, const fe51 a, int n)
+{
+	fe51_sq(o, a);
+	while (--n)
+		fe51_sq(o, o);
+}
+
+static void fe51_mul_121665(fe51 o, const fe51 a)
+{
+	u128 r[5];
+	for (int i = 0; i < 5; i++)
+		r[i] = (u128)a[i] * 121665;
+
+	fe51_reduce(o, r);
+}
+
+static void fe51_cmov(fe51 a, const fe51 b, uint64_t move)
+{
+	uint64_t mask = -move;
+
+	for (int i = 0; i < 5; i++)
+		a[i] ^= mask & (a[i] ^ b[i]);
+}
+
+static void fe51_cswap(fe51 a, fe51 b, uint64_t swap)
+{
+	uint64_t mask = -swap;
+
+	for (int i = 0; i < 5; i++) {
+		uint64_t t = mask & (a[i] ^ b[i]);
+		a[i] ^= t;
+		b[i] ^= t;
+	}
+}
+
+/* z^(2^250 - 1), also returns z^11 as a byproduct for fe51_invert */
+static void fe51_pow2_250_1(fe51 o, fe51 z11, const fe51 z)
+{
+	fe51 z2, z9, z2_5_0, z2_10_0, z2_20_0, z2_50_0, z2_100_0, t;
+
+	fe51_sq(z2, z);                  // 2
+	fe51_sq_n(t, z2, 2);             // 8
+	fe51_mul(z9, t, z);              // 9
+	fe51_mul(z11, z9, z2);           // 11
+	fe51_sq(t, z11);                 // 22
+	fe51_mul(z2_5_0, t, z9);         // 2^5 - 2^0
+	fe51_sq_n(t, z2_5_0, 5);
+	fe51_mul(z2_10_0, t, z2_5_0);    // 2^10 - 2^0
+	fe51_sq_n(t, z2_10_0, 10);
+	fe51_mul(z2_20_0, t, z2_10_0);   // 2^20 - 2^0
+	fe51_sq_n(t, z2_20_0, 20);
+	fe51_mul(t, t, z2_20_0);         // 2^40 - 2^0
+	fe51_sq_n(t, t, 10);
+	fe51_mul(z2_50_0, t, z2_10_0);   // 2^50 - 2^0
+	fe51_sq_n(t, z2_50_0, 50);
+	fe51_mul(z2_100_0, t, z2_50_0);  // 2^100 - 2^0
+	fe51_sq_n(t, z2_100_0, 100);
+	fe51_mul(t, t, z2_100_0);        // 2^200 - 2^0
+	fe51_sq_n(t, t, 50);
+	fe51_mul(o, t, z2_50_0);         // 2^250 - 2^0
+}
+
+/* a^(p-2) using the usual addition chain, 254 squarings and 11
+ * multiplications, or safegcd if selected at build time */
+static void fe51_invert(fe51 o, const fe51 z)
+{
+#ifdef HAVE_SAFEGCD
+	uint8_t b[32];
+
+	fe51_tobytes(b, z);
+	x25519_invert_safegcd(b, b);
+	fe51_frombytes(o, b);
+#else
+	fe51 z11, t;
+
+	fe51_pow2_250_1(t, z11, z);
+	fe51_sq_n(t, t, 5);              // 2^255 - 2^5
+	fe51_mul(o, t, z11);             // 2^255 - 21
+#endif
+}
+
+/* z^((p-5)/8) = z^(2^252 - 3) */
+static void fe51_pow22523(fe51 o, const fe51 z)
+{
+	fe51 z11, t;
+
+	fe51_pow2_250_1(t, z11, z);
+	fe51_sq_n(t, t, 2);              // 2^252 - 2^2
+	fe51_mul(o, t, z);               // 2^252 - 3
+}
+
+static const fe51 fe51_one = {1};
+
+static bool fe51_eq(const fe51 a, const fe51 b)
+{
+	uint8_t ab[32], bb[32];
+
+	fe51_tobytes(ab, a);
+	fe51_tobytes(bb, b);
+
+	return memcmp(ab, bb, 32) == 0;
+}
+
+static uint64_t fe51_iszero(const fe51 a)
+{
+	uint8_t b[32];
+	uint8_t acc = 0;
+
+	fe51_tobytes(b, a);
+	for (int i = 0; i < 32; i++)
+		acc |= b[i];
+
+	return ((uint64_t)acc - 1) >> 63;
+}
+
+/* q = x / z, with 0 for z = 0 just as the ladder would output */
+static void fe51_div(uint8_t *q, const fe51 x, const fe51 z)
+{
+	fe51 t;
+
+	fe51_invert(t, z);
+	fe51_mul(t, x, t);
+	fe51_tobytes(q, t);
+}
+
+/* q[k] = x[k] / z[k] for count elements using a single inversion (Montgomery's
+ * trick). Zero denominators are replaced by one (zeroing the numerator) first
+ * so that they cannot spoil the other results. x and z are clobbered. */
+static void fe51_div_batch(uint8_t (*q)[32], fe51 *x, fe51 *z, int count)
+{
+	static const fe51 zero;
+	fe51 prod[LADDER_BATCH], inv, zinv;
+
+	if (count <= 0)
+		return;
+
+	for (int k = 0; k < count; k++) {
+		uint64_t is_zero = fe51_iszero(z[k]);
+
+		fe51_cmov(x[k], zero, is_zero);
+		fe51_cmov(z[k], fe51_one, is_zero);
+
+		if (k > 0)
+			fe51_mul(prod[k], prod[k-1], z[k]);
+		else
+			memcpy(prod[0], z[0], sizeof(fe51));
+	}
+
+	fe51_invert(inv, prod[count-1]);
+
+	for (int k = count - 1; k >= 0; k--) {
+		if (k > 0) {
+			fe51_mul(zinv, inv, prod[k-1]);
+			fe51_mul(inv, inv, z[k]);
+		} else {
+			memcpy(zinv, inv, sizeof(fe51));
+		}
+
+		fe51_mul(zinv, zinv, x[k]);
+		fe51_tobytes(q[k], zinv);
+	}
+}
+
+static void clamp(uint8_t e[static 32], const uint8_t *n)
+{
+	memcpy(e, n, 32);
+	e[0] &= 248;
+	e[31] = (e[31] & 127) | 64;
+}
+
+/* Edwards curve arithmetic, as in ref10 */
+
+static const fe51 fe51_d = {
+	0x34dca135978a3, 0x1a8283b156ebd, 0x5e7a26001c029, 0x739c663a03cbb, 0x52036cee2b6ff
+};
+static const fe51 fe51_d2 = {
+	0x69b9426b2f159, 0x35050762add7a, 0x3cf44c0038052, 0x6738cc7407977, 0x2406d9dc56dff
+};
+static const fe51 fe51_sqrtm1 = {
+	0x61b274a0ea0b0, 0xd5a5fc8f189d, 0x7ef5e9cbd0c60, 0x78595a6804c9e, 0x2b8324804fc1d
+};
+
+// extended coordinates, x = X/Z, y = Y/Z, x*y = T/Z
+struct ge_p3 {
+	fe51 X, Y, Z, T;
+};
+
+// completed coordinates, x = X/Z, y = Y/T
+struct ge_p1p1 {
+	fe51 X, Y, Z, T;
+};
+
+// projective coordinates, x = X/Z, y = Y/Z
+struct ge_p2 {
+	fe51 X, Y, Z;
+};
+
+// addition operand, (Y + X, Y - X, Z, 2*d*T)
+struct ge_cached {
+	fe51 YplusX, YminusX, Z, T2d;
+};
+
+// affine table entries, (y + x, y - x, 2*d*x*y)
+struct ge_precomp {
+	fe51 yplusx, yminusx, xy2d;
+};
+
+// table of (j + 1) * 256^i * P for i = 0..31, j = 0..7
+typedef fe51 ge_table[32][8][3];
+
+static void ge_p1p1_to_p2(struct ge_p2 *r, const struct ge_p1p1 *p)
+{
+	fe51_mul(r->X, p->X, p->T);
+	fe51_mul(r->Y, p->Y, p->Z);
+	fe51_mul(r->Z, p->Z, p->T);
+}
+
+static void ge_p1p1_to_p3(struct ge_p3 *r, const struct ge_p1p1 *p)
+{
+	fe51_mul(r->X, p->X, p->T);
+	fe51_mul(r->Y, p->Y, p->Z);
+	fe51_mul(r->Z, p->Z, p->T);
+	fe51_mul(r->T, p->X, p->Y);
+}
+
+static void ge_p3_to_p2(struct ge_p2 *r, const struct ge_p3 *p)
+{
+	memcpy(r->X, p->X, sizeof(r->X));
+	memcpy(r->Y, p->Y, sizeof(r->Y));
+	memcpy(r->Z, p->Z, sizeof(r->Z));
+}
+
+static void ge_p3_to_cached(struct ge_cached *r, const struct ge_p3 *p)
+{
+	fe51_add(r->YplusX, p->Y, p->X);
+	fe51_sub(r->YminusX, p->Y, p->X);
+	memcpy(r->Z, p->Z, sizeof(r->Z));
+	fe51_mul(r->T2d, p->T, fe51_d2);
+}
+
+static void ge_p2_dbl(struct ge_p1p1 *r, const struct ge_p2 *p)
+{
+	fe51 t;
+
+	fe51_sq(r->X, p->X);
+	fe51_sq(r->Z, p->Y);
+	fe51_sq(r->T, p->Z);
+	fe51_add(r->T, r->T, r->T);
+	fe51_add(r->Y, p->X, p->Y);
+	fe51_sq(t, r->Y);
+	fe51_add(r->Y, r->Z, r->X);
+	fe51_sub(r->Z, r->Z, r->X);
+	fe51_sub(r->X, t, r->Y);
+	fe51_carry(r->Z); // r->Z is subtracted from again below
+	fe51_sub(r->T, r->T, r->Z);
+}
+
+static void ge_add(struct ge_p1p1 *r, const struct ge_p3 *p, const struct ge_cached *q)
+{
+	fe51 t;
+
+	fe51_add(r->X, p->Y, p->X);
+	fe51_sub(r->Y, p->Y, p->X);
+	fe51_mul(r->Z, r->X, q->YplusX);
+	fe51_mul(r->Y, r->Y, q->YminusX);
+	fe51_mul(r->T, q->T2d, p->T);
+	fe51_mul(r->X, p->Z, q->Z);
+	fe51_add(t, r->X, r->X);
+	fe51_sub(r->X, r->Z, r->Y);
+	fe51_add(r->Y, r->Z, r->Y);
+	fe51_add(r->Z, t, r->T);
+	fe51_sub(r->T, t, r->T);
+}
+
+static void ge_madd(struct ge_p1p1 *r, const struct ge_p3 *p, const struct ge_precomp *q)
+{
+	fe51 t;
+
+	fe51_add(r->X, p->Y, p->X);
+	fe51_sub(r->Y, p->Y, p->X);
+	fe51_mul(r->Z, r->X, q->yplusx);
+	fe51_mul(r->Y, r->Y, q->yminusx);
+	fe51_mul(r->T, q->xy2d, p->T);
+	fe51_add(t, p->Z, p->Z);
+	fe51_sub(r->X, r->Z, r->Y);
+	fe51_add(r->Y, r->Z, r->Y);
+	fe51_add(r->Z, t, r->T);
+	fe51_sub(r->T, t, r->T);
+}
+
+static void ge_select(struct ge_precomp *t, const fe51 (*row)[3], int8_t b)
+{
+	static const fe51 zero;
+
+	uint8_t negative = (uint8_t)b >> 7;
+	uint8_t babs = (b ^ -negative) + negative;
+
+	memset(t, 0, sizeof(*t));
+	t->yplusx[0] = 1;
+	t->yminusx[0] = 1;
+
+	for (int j = 0; j < 8; j++) {
+		uint64_t eq = ((uint64_t)(babs ^ (j + 1)) - 1) >> 63;
+
+		fe51_cmov(t->yplusx,  row[j][0], eq);
+		fe51_cmov(t->yminusx, row[j][1], eq);
+		fe51_cmov(t->xy2d,    row[j][2], eq);
+	}
+
+	// -(x, y) = (-x, y): swap y + x and y - x, negate 2*d*x*y
+	fe51 neg;
+	fe51_sub(neg, zero, t->xy2d);
+	fe51_cswap(t->yplusx, t->yminusx, negative);
+	fe51_cmov(t->xy2d, neg, negative);
+}
+
+/* Computes the Montgomery u coordinate of a * P as u = num / den, where P is
+ * given by a ge_table. a is clamped as for X25519. */
+static void ge_scalarmult_table(fe51 num, fe51 den, const uint8_t *n, const fe51 (*table)[8][3])
+{
+	uint8_t a[32];
+	clamp(a, n);
+
+	// a = sum e[i] * 16^i with -8 <= e[i] <= 8
+	int8_t e[64];
+	for (int i = 0; i < 32; i++) {
+		e[2*i+0] = (a[i] >> 0) & 15;
+		e[2*i+1] = (a[i] >> 4) & 15;
+	}
+
+	int8_t carry = 0;
+	for (int i = 0; i < 63; i++) {
+		e[i] += carry;
+		carry = (e[i] + 8) >> 4;
+		e[i] -= carry << 4;
+	}
+	e[63] += carry;
+
+	struct ge_p3 h;
+	struct ge_p2 s;
+	struct ge_p1p1 r;
+	struct ge_precomp t;
+
+	memset(&h, 0, sizeof(h));
+	h.Y[0] = 1;
+	h.Z[0] = 1;
+
+	for (int i = 1; i < 64; i += 2) {
+		ge_select(&t, table[i / 2], e[i]);
+		ge_madd(&r, &h, &t);
+		ge_p1p1_to_p3(&h, &r);
+	}
+
+	ge_p3_to_p2(&s, &h);
+	for (int i = 0; i < 3; i++) {
+		ge_p2_dbl(&r, &s);
+		ge_p1p1_to_p2(&s, &r);
+	}
+	ge_p2_dbl(&r, &s);
+	ge_p1p1_to_p3(&h, &r);
+
+	for (int i = 0; i < 64; i += 2) {
+		ge_select(&t, table[i / 2], e[i]);
+		ge_madd(&r, &h, &t);
+		ge_p1p1_to_p3(&h, &r);
+	}
+
+	// u = (1 + y) / (1 - y) = (Z + Y) / (Z - Y)
+	fe51_add(num, h.Z, h.Y);
+	fe51_sub(den, h.Z, h.Y);
+
+	wipe_sized(a);
+	wipe_sized(e);
+	wipe_sized(h);
+	wipe_sized(t);
+}
+
+/* Maps the Montgomery u coordinate to one of the two corresponding Edwards
+ * points. Which one does not matter since both have the same u coordinate
+ * for all multiples. Fails for points on the twist and for u = -1. Not
+ * constant time, only meant for public points. */
+static int ge_from_montgomery(struct ge_p3 *h, const uint8_t *p)
+{
+	fe51 u, num, den, y2, v, v3, vxx, check;
+
+	fe51_frombytes(u, p);
+	fe51_sub(num, u, fe51_one);
+	fe51_add(den, u, fe51_one);
+	fe51_carry(den);
+
+	static const fe51 zero;
+	if (fe51_eq(den, zero))
+		return -1;
+
+	// y = (u - 1) / (u + 1)
+	memset(h, 0, sizeof(*h));
+	fe51_invert(den, den);
+	fe51_mul(h->Y, num, den);
+	h->Z[0] = 1;
+
+	// x^2 = (y^2 - 1) / (d*y^2 + 1) = num / v
+	fe51_sq(y2, h->Y);
+	fe51_mul(v, y2, fe51_d);
+	fe51_sub(num, y2, fe51_one);
+	fe51_add(v, v, fe51_one);
+	fe51_carry(v);
+
+	// x = num * v^3 * (num * v^7)^((p-5)/8)
+	fe51_sq(v3, v);
+	fe51_mul(v3, v3, v);
+	fe51_sq(h->X, v3);
+	fe51_mul(h->X, h->X, v);
+	fe51_mul(h->X, h->X, num);
+	fe51_pow22523(h->X, h->X);
+	fe51_mul(h->X, h->X, v3);
+	fe51_mul(h->X, h->X, num);
+
+	fe51_sq(vxx, h->X);
+	fe51_mul(vxx, vxx, v);
+	fe51_carry(num);
+	if (!fe51_eq(vxx, num)) {
+		fe51_sub(check, zero, num);
+		if (!fe51_eq(vxx, check))
+			return -1;
+
+		fe51_mul(h->X, h->X, fe51_sqrtm1);
+	}
+
+	fe51_mul(h->T, h->X, h->Y);
+
+	return 0;
+}
+
+int x25519_table_init_fe51(fe51 (*table)[8][3], const uint8_t *p)
+{
+	struct ge_p3 row, acc, pts[8];
+	struct ge_cached c;
+	struct ge_p1p1 r;
+	struct ge_p2 s;
+
+	if (ge_from_montgomery(&row, p) < 0)
+		return -1;
+
+	// collect the projective points, Z in table[i][j][2] for now
+	for (int i = 0; i < 32; i++) {
+		ge_p3_to_cached(&c, &row);
+		pts[0] = row;
+
+		for (int j = 1; j < 8; j++) {
+			ge_add(&r, &pts[j-1], &c);
+			ge_p1p1_to_p3(&pts[j], &r);
+		}
+
+		for (int j = 0; j < 8; j++) {
+			memcpy(table[i][j][0], pts[j].X, sizeof(fe51));
+			memcpy(table[i][j][1], pts[j].Y, sizeof(fe51));
+			memcpy(table[i][j][2], pts[j].Z, sizeof(fe51));
+		}
+
+		ge_p3_to_p2(&s, &row);
+		for (int k = 0; k < 7; k++) {
+			ge_p2_dbl(&r, &s);
+			ge_p1p1_to_p2(&s, &r);
+		}
+		ge_p2_dbl(&r, &s);
+		ge_p1p1_to_p3(&acc, &r);
+		row = acc;
+	}
+
+	// invert all Z at once (Montgomery's trick), Z is never zero for
+	// points on the curve
+	fe51 prod[256], inv, t;
+
+	memcpy(prod[0], table[0][0][2], sizeof(fe51));
+	for (int k = 1; k < 256; k++)
+		fe51_mul(prod[k], prod[k-1], table[k / 8][k % 8][2]);
+
+	fe51_invert(inv, prod[255]);
+
+	for (int k = 255; k >= 0; k--) {
+		fe51 *entry = table[k / 8][k % 8];
+		fe51 zinv, x, y;
+
+		if (k > 0) {
+			fe51_mul(zinv, inv, prod[k-1]);
+			fe51_mul(inv, inv, entry[2]);
+		} else {
+			memcpy(zinv, inv, sizeof(fe51));
+		}
+
+		fe51_mul(x, entry[0], zinv);
+		fe51_mul(y, entry[1], zinv);
+
+		fe51_add(entry[0], y, x);
+		fe51_sub(entry[1], y, x);
+		fe51_mul(t, x, y);
+		fe51_mul(entry[2], t, fe51_d2);
+
+		fe51_carry(entry[0]);
+		fe51_carry(entry[1]);
+	}
+
+	return 0;
+}
+
+int crypto_scalarmult_table_fe51(uint8_t *q, const uint8_t *n, const fe51 (*table)[8][3])
+{
+	fe51 num, den;
+
+	ge_scalarmult_table(num, den, n, table);
+	fe51_div(q, num, den);
+
+	return 0;
+}
+
+#ifdef HAVE_BASE_TABLE
+int crypto_scalarmult_base_fe51(uint8_t *q, const uint8_t *n)
+{
+	fe51 num, den;
+
+	ge_scalarmult_table(num, den, n, base_table);
+	fe51_div(q, num, den);
+
+	return 0;
+}
+#endif
+
+/* Montgomery ladder, RFC7748 Section 5 */
+
+struct ladder {
+	fe51 x1, x2, z2, x3, z3;
+};
+
+static void ladder_init(struct ladder *l, const fe51 x1)
+{
+	memset(l, 0, sizeof(*l));
+	memcpy(l->x1, x1, sizeof(l->x1));
+	memcpy(l->x3, x1, sizeof(l->x3));
+	l->x2[0] = 1;
+	l->z3[0] = 1;
+}
+
+static void ladder_cswap(struct ladder *l, uint64_t swap)
+{
+	fe51_cswap(l->x2, l->x3, swap);
+	fe51_cswap(l->z2, l->z3, swap);
+}
+
+static inline void ladder_step(struct ladder *l)
+{
+	fe51 a, aa, b, bb, c, d, da, cb, t;
+
+	fe51_add(a, l->x2, l->z2);
+	fe51_sub(b, l->x2, l->z2);
+	fe51_add(c, l->x3, l->z3);
+	fe51_sub(d, l->x3, l->z3);
+	fe51_sq(aa, a);
+	fe51_sq(bb, b);
+	fe51_mul(da, d, a);
+	fe51_mul(cb, c, b);
+
+	fe51_add(t, da, cb);
+	fe51_sq(l->x3, t);
+	fe51_sub(t, da, cb);
+	fe51_sq(t, t);
+	fe51_mul(l->z3, t, l->x1);
+
+	fe51_mul(l->x2, aa, bb);
+	fe51_sub(t, aa, bb);          // E = AA - BB
+	fe51_mul_121665(a, t);
+	fe51_add(a, a, aa);
+	fe51_mul(l->z2, t, a);
+}
+
+/* Runs the ladder for all points in l at once. Decoding the scalar and the
+ * swap masks are shared and the independent steps can overlap in the
+ * pipeline. */
+static inline void ladder_run(struct ladder *l, int count, const uint8_t *n)
+{
+	uint8_t e[32];
+	clamp(e, n);
+
+	uint64_t swap = 0;
+	for (int i = 254; i >= 0; i--) {
+		uint64_t bit = (e[i >> 3] >> (i & 7)) & 1;
+
+		swap ^= bit;
+		for (int k = 0; k < count; k++)
+			ladder_cswap(&l[k], swap);
+		swap = bit;
+
+		for (int k = 0; k < count; k++)
+			ladder_step(&l[k]);
+	}
+
+	for (int k = 0; k < count; k++)
+		ladder_cswap(&l[k], swap);
+
+	wipe_sized(e);
+}
+
+int crypto_scalarmult_fe51(uint8_t *q, const uint8_t *n, const uint8_t *p)
+{
+	fe51 x1;
+	struct ladder l;
+
+	fe51_frombytes(x1, p);
+	ladder_init(&l, x1);
+	ladder_run(&l, 1, n);
+
+	fe51_div(q, l.x2, l.z2);
+
+	wipe_sized(l);
+
+	return 0;
+}
+
+int crypto_scalarmult_base_pair_fe51(uint8_t *q_base, uint8_t *q, const uint8_t *n, const uint8_t *p,
+                                     const fe51 (*p_table)[8][3])
+{
+	fe51 x1, x[2], z[2];
+	uint8_t out[2][32];
+	struct ladder l[2];
+
+	fe51_frombytes(x1, p);
+
+#ifdef HAVE_BASE_TABLE
+	ge_scalarmult_table(x[0], z[0], n, base_table);
+
+	if (p_table) {
+		ge_scalarmult_table(l[1].x2, l[1].z2, n, p_table);
+	} else {
+		ladder_init(&l[1], x1);
+		ladder_run(&l[1], 1, n);
+	}
+#else
+	static const uint8_t nine[32] = {9};
+
+	if (p_table) {
+		fe51_frombytes(x1, nine);
+		ladder_init(&l[0], x1);
+		ladder_run(&l[0], 1, n);
+		ge_scalarmult_table(l[1].x2, l[1].z2, n, p_table);
+	} else {
+		ladder_init(&l[1], x1);
+		fe51_frombytes(x1, nine);
+		ladder_init(&l[0], x1);
+		ladder_run(l, 2, n);
+	}
+
+	memcpy(x[0], l[0].x2, sizeof(fe51));
+	memcpy(z[0], l[0].z2, sizeof(fe51));
+#endif
+
+	memcpy(x[1], l[1].x2, sizeof(fe51));
+	memcpy(z[1], l[1].z2, sizeof(fe51));
+
+	fe51_div_batch(out, x, z, 2);
+	memcpy(q_base, out[0], 32);
+	memcpy(q, out[1], 32);
+
+	wipe_sized(l);
+	wipe_sized(x);
+	wipe_sized(z);
+	wipe_sized(out);
+
+	return 0;
+}
+
+int crypto_scalarmult_batch_fe51(uint8_t *q, const uint8_t *n, const uint8_t *p, size_t count)
+{
+	fe51 x1, x[LADDER_BATCH], z[LADDER_BATCH];
+	struct ladder l[LADDER_BATCH];
+
+	while (count) {
+		int m = count < LADDER_BATCH ? count : LADDER_BATCH;
+
+		for (int k = 0; k < m; k++) {
+			fe51_frombytes(x1, p + 32 * k);
+			ladder_init(&l[k], x1);
+		}
+
+		// keep the projective results and normalize them all at once
+		ladder_run(l, m, n);
+
+		for (int k = 0; k < m; k++) {
+			memcpy(x[k], l[k].x2, sizeof(fe51));
+			memcpy(z[k], l[k].z2, sizeof(fe51));
+		}
+
+		fe51_div_batch((uint8_t (*)[32])q, x, z, m);
+
+		q += 32 * m;
+		p += 32 * m;
+		count -= m;
+	}
+
+	wipe_sized(l);
+	wipe_sized(x);
+	wipe_sized(z);
+
+	return 0;
+}
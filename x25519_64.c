@@ -0,0 +1,446 @@
+// X25519 on four 64 bit limbs with BMI2/ADX
+//
+// Field elements are stored as four 64 bit words and are only kept below
+// 2^256, not below p. Since 2^256 = 38 mod p, the upper half of a product and
+// the carries of additions are folded back into the lower words multiplied
+// by 38.
+//
+// Multiplication and squaring are written in inline assembly with MULX and
+// two independent carry chains (ADCX and ADOX), including the reduction.
+// Everything else is plain C. This is only built on x86-64 (HAVE_MULX), and
+// crypto_scalarmult only calls it on CPUs supporting BMI2 and ADX, see
+// x25519_dispatch.
+
+#include <stdint.h>
+#include <string.h>
+
+#include "utils.h"
+
+#include "x25519.h"
+
+typedef unsigned __int128 u128;
+typedef uint64_t fe64[4];
+
+static void fe64_frombytes(fe64 o, const uint8_t in[static 32])
+{
+	for (int i = 0; i < 4; i++)
+		o[i] = unp64le(in + 8 * i);
+
+	o[3] &= INT64_MAX;
+}
+
+static void fe64_tobytes(uint8_t out[static 32], const fe64 a)
+{
+	fe64 t, u;
+	u128 c;
+
+	// fold bit 255, t < 2^255 + 19 then
+	c = (u128)(a[3] >> 63) * 19;
+	for (int i = 0; i < 4; i++) {
+		c += (i == 3) ? (a[3] & INT64_MAX) : a[i];
+		t[i] = c;
+		c >>= 64;
+	}
+
+	// t - p = t + 19 - 2^255, use it iff t + 19 reaches 2^255
+	c = 19;
+	for (int i = 0; i < 4; i++) {
+		c += t[i];
+		u[i] = c;
+		c >>= 64;
+	}
+
+	uint64_t mask = -(u[3] >> 63);
+	u[3] &= INT64_MAX;
+
+	for (int i = 0; i < 4; i++) {
+		uint64_t w = t[i] ^ (mask & (t[i] ^ u[i]));
+
+		for (int j = 0; j < 8; j++)
+			out[8*i + j] = w >> (8*j);
+	}
+}
+
+// Additions and subtractions fold their carry (borrow) as 38 (-38), a second
+// carry leaves a result below 38 (above 2^256 - 38), so the third fold
+// cannot carry anymore.
+
+static void fe64_add(fe64 o, const fe64 a, const fe64 b)
+{
+	__asm__ (
+		"mov $38, %%ecx\n\t"
+		"mov 0(%1), %%r8\n\t"
+		"add 0(%2), %%r8\n\t"
+		"mov 8(%1), %%r9\n\t"
+		"adc 8(%2), %%r9\n\t"
+		"mov 16(%1), %%r10\n\t"
+		"adc 16(%2), %%r10\n\t"
+		"mov 24(%1), %%r11\n\t"
+		"adc 24(%2), %%r11\n\t"
+		"mov $0, %%eax\n\t"
+		"cmovc %%rcx, %%rax\n\t"
+		"add %%rax, %%r8\n\t"
+		"adc $0, %%r9\n\t"
+		"adc $0, %%r10\n\t"
+		"adc $0, %%r11\n\t"
+		"mov $0, %%eax\n\t"
+		"cmovc %%rcx, %%rax\n\t"
+		"add %%rax, %%r8\n\t"
+		"mov %%r8, 0(%0)\n\t"
+		"mov %%r9, 8(%0)\n\t"
+		"mov %%r10, 16(%0)\n\t"
+		"mov %%r11, 24(%0)\n\t"
+		:
+		: "r"(o), "r"(a), "r"(b)
+		: "rax", "rcx", "r8", "r9", "r10", "r11", "cc", "memory"
+	);
+}
+
+static void fe64_sub(fe64 o, const fe64 a, const fe64 b)
+{
+	__asm__ (
+		"mov $38, %%ecx\n\t"
+		"mov 0(%1), %%r8\n\t"
+		"sub 0(%2), %%r8\n\t"
+		"mov 8(%1), %%r9\n\t"
+		"sbb 8(%2), %%r9\n\t"
+		"mov 16(%1), %%r10\n\t"
+		"sbb 16(%2), %%r10\n\t"
+		"mov 24(%1), %%r11\n\t"
+		"sbb 24(%2), %%r11\n\t"
+		"mov $0, %%eax\n\t"
+		"cmovc %%rcx, %%rax\n\t"
+		"sub %%rax, %%r8\n\t"
+		"sbb $0, %%r9\n\t"
+		"sbb $0, %%r10\n\t"
+		"sbb $0, %%r11\n\t"
+		"mov $0, %%eax\n\t"
+		"cmovc %%rcx, %%rax\n\t"
+		"sub %%rax, %%r8\n\t"
+		"mov %%r8, 0(%0)\n\t"
+		"mov %%r9, 8(%0)\n\t"
+		"mov %%r10, 16(%0)\n\t"
+		"mov %%r11, 24(%0)\n\t"
+		:
+		: "r"(o), "r"(a), "r"(b)
+		: "rax", "rcx", "r8", "r9", "r10", "r11", "cc", "memory"
+	);
+}
+
+static void fe64_mul_121665(fe64 o, const fe64 a)
+{
+	__asm__ (
+		"mov $121665, %%edx\n\t"
+		"mulx 0(%1), %%r8, %%r9\n\t"
+		"mulx 8(%1), %%rax, %%r10\n\t"
+		"add %%rax, %%r9\n\t"
+		"mulx 16(%1), %%rax, %%r11\n\t"
+		"adc %%rax, %%r10\n\t"
+		"mulx 24(%1), %%rax, %%rcx\n\t"
+		"adc %%rax, %%r11\n\t"
+		"adc $0, %%rcx\n\t"
+		"imul $38, %%rcx, %%rcx\n\t"
+		"add %%rcx, %%r8\n\t"
+		"adc $0, %%r9\n\t"
+		"adc $0, %%r10\n\t"
+		"adc $0, %%r11\n\t"
+		"mov $38, %%ecx\n\t"
+		"mov $0, %%eax\n\t"
+		"cmovc %%rcx, %%rax\n\t"
+		"add %%rax, %%r8\n\t"
+		"mov %%r8, 0(%0)\n\t"
+		"mov %%r9, 8(%0)\n\t"
+		"mov %%r10, 16(%0)\n\t"
+		"mov %%r11, 24(%0)\n\t"
+		:
+		: "r"(o), "r"(a)
+		: "rax", "rcx", "rdx", "r8", "r9", "r10", "r11", "cc", "memory"
+	);
+}
+
+// reduces the 512 bit value in r8..r15 to four words and stores them to %0,
+// expects the upper half folded in as 38 * r12..r15 and the resulting carry
+// folded in again as 38 * carry (which cannot overflow anymore)
+#define FE64_REDUCE \
+		"mov $38, %%edx\n\t" \
+		"xor %%eax, %%eax\n\t" \
+		"mulx %%r12, %%rax, %%rbx\n\t" \
+		"adcx %%rax, %%r8\n\t" \
+		"adox %%rbx, %%r9\n\t" \
+		"mulx %%r13, %%rax, %%rbx\n\t" \
+		"adcx %%rax, %%r9\n\t" \
+		"adox %%rbx, %%r10\n\t" \
+		"mulx %%r14, %%rax, %%rbx\n\t" \
+		"adcx %%rax, %%r10\n\t" \
+		"adox %%rbx, %%r11\n\t" \
+		"mulx %%r15, %%rax, %%r12\n\t" \
+		"adcx %%rax, %%r11\n\t" \
+		"mov $0, %%rbx\n\t" \
+		"adcx %%rbx, %%r12\n\t" \
+		"adox %%rbx, %%r12\n\t" \
+		"imul $38, %%r12, %%r12\n\t" \
+		"add %%r12, %%r8\n\t" \
+		"adc $0, %%r9\n\t" \
+		"adc $0, %%r10\n\t" \
+		"adc $0, %%r11\n\t" \
+		"mov $0, %%rbx\n\t" \
+		"cmovc %%rdx, %%rbx\n\t" \
+		"add %%rbx, %%r8\n\t" \
+		"mov %%r8, 0(%0)\n\t" \
+		"mov %%r9, 8(%0)\n\t" \
+		"mov %%r10, 16(%0)\n\t" \
+		"mov %%r11, 24(%0)\n\t"
+
+#define FE64_CLOBBERS "rax", "rbx", "rdx", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15", "cc", "memory"
+
+static void fe64_mul(fe64 o, const fe64 a, const fe64 b)
+{
+	// row i adds a * b[i] to r8..r15, with the low halves of the
+	// products on the CF chain and the high halves on the OF chain
+	__asm__ (
+		"xor %%r8, %%r8\n\t"
+		"xor %%r9, %%r9\n\t"
+		"xor %%r10, %%r10\n\t"
+		"xor %%r11, %%r11\n\t"
+		"xor %%r12, %%r12\n\t"
+		"mov 0(%1), %%rdx\n\t"
+		"xor %%eax, %%eax\n\t"
+		"mulx 0(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r8\n\t"
+		"adox %%rbx, %%r9\n\t"
+		"mulx 8(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r9\n\t"
+		"adox %%rbx, %%r10\n\t"
+		"mulx 16(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r10\n\t"
+		"adox %%rbx, %%r11\n\t"
+		"mulx 24(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r11\n\t"
+		"adox %%rbx, %%r12\n\t"
+		"adc $0, %%r12\n\t"
+		"mov 8(%1), %%rdx\n\t"
+		"xor %%r13, %%r13\n\t"
+		"xor %%eax, %%eax\n\t"
+		"mulx 0(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r9\n\t"
+		"adox %%rbx, %%r10\n\t"
+		"mulx 8(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r10\n\t"
+		"adox %%rbx, %%r11\n\t"
+		"mulx 16(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r11\n\t"
+		"adox %%rbx, %%r12\n\t"
+		"mulx 24(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r12\n\t"
+		"adox %%rbx, %%r13\n\t"
+		"adc $0, %%r13\n\t"
+		"mov 16(%1), %%rdx\n\t"
+		"xor %%r14, %%r14\n\t"
+		"xor %%eax, %%eax\n\t"
+		"mulx 0(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r10\n\t"
+		"adox %%rbx, %%r11\n\t"
+		"mulx 8(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r11\n\t"
+		"adox %%rbx, %%r12\n\t"
+		"mulx 16(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r12\n\t"
+		"adox %%rbx, %%r13\n\t"
+		"mulx 24(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r13\n\t"
+		"adox %%rbx, %%r14\n\t"
+		"adc $0, %%r14\n\t"
+		"mov 24(%1), %%rdx\n\t"
+		"xor %%r15, %%r15\n\t"
+		"xor %%eax, %%eax\n\t"
+		"mulx 0(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r11\n\t"
+		"adox %%rbx, %%r12\n\t"
+		"mulx 8(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r12\n\t"
+		"adox %%rbx, %%r13\n\t"
+		"mulx 16(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r13\n\t"
+		"adox %%rbx, %%r14\n\t"
+		"mulx 24(%2), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r14\n\t"
+		"adox %%rbx, %%r15\n\t"
+		"adc $0, %%r15\n\t"
+		FE64_REDUCE
+		:
+		: "r"(o), "r"(b), "r"(a)
+		: FE64_CLOBBERS
+	);
+}
+
+static void fe64_sq(fe64 o, const fe64 a)
+{
+	// the cross products a[i] a[j] for i < j are computed once and
+	// doubled, then the squares a[i]^2 are added
+	__asm__ (
+		"xor %%r15, %%r15\n\t"
+		"mov 0(%1), %%rdx\n\t"
+		"mulx 8(%1), %%r9, %%r10\n\t"
+		"mulx 16(%1), %%rax, %%r11\n\t"
+		"adcx %%rax, %%r10\n\t"
+		"mulx 24(%1), %%rax, %%r12\n\t"
+		"adcx %%rax, %%r11\n\t"
+		"adcx %%r15, %%r12\n\t"
+		"mov 8(%1), %%rdx\n\t"
+		"mulx 16(%1), %%rax, %%rbx\n\t"
+		"adcx %%rax, %%r11\n\t"
+		"adox %%rbx, %%r12\n\t"
+		"mulx 24(%1), %%rax, %%r13\n\t"
+		"adcx %%rax, %%r12\n\t"
+		"mov 16(%1), %%rdx\n\t"
+		"mulx 24(%1), %%rax, %%r14\n\t"
+		"adcx %%rax, %%r13\n\t"
+		"adox %%r15, %%r13\n\t"
+		"adcx %%r15, %%r14\n\t"
+		"adox %%r15, %%r14\n\t"
+		"mov 0(%1), %%rdx\n\t"
+		"mulx %%rdx, %%r8, %%rax\n\t"
+		"adcx %%r9, %%r9\n\t"
+		"adox %%rax, %%r9\n\t"
+		"mov 8(%1), %%rdx\n\t"
+		"mulx %%rdx, %%rax, %%rbx\n\t"
+		"adcx %%r10, %%r10\n\t"
+		"adox %%rax, %%r10\n\t"
+		"adcx %%r11, %%r11\n\t"
+		"adox %%rbx, %%r11\n\t"
+		"mov 16(%1), %%rdx\n\t"
+		"mulx %%rdx, %%rax, %%rbx\n\t"
+		"adcx %%r12, %%r12\n\t"
+		"adox %%rax, %%r12\n\t"
+		"adcx %%r13, %%r13\n\t"
+		"adox %%rbx, %%r13\n\t"
+		"mov 24(%1), %%rdx\n\t"
+		"mulx %%rdx, %%rax, %%rbx\n\t"
+		"adcx %%r14, %%r14\n\t"
+		"adox %%rax, %%r14\n\t"
+		"adcx %%r15, %%r15\n\t"
+		"adox %%rbx, %%r15\n\t"
+		FE64_REDUCE
+		:
+		: "r"(o), "r"(a)
+		: FE64_CLOBBERS
+	);
+}
+
+#ifndef HAVE_SAFEGCD
+static void fe64_sq_n(fe64 o, const fe64 a, int n)
+{
+	fe64_sq(o, a);
+	while (--n)
+		fe64_sq(o, o);
+}
+#endif
+
+static void fe64_cswap(fe64 a, fe64 b, uint64_t swap)
+{
+	uint64_t mask = -swap;
+
+	for (int i = 0; i < 4; i++) {
+		uint64_t t = mask & (a[i] ^ b[i]);
+		a[i] ^= t;
+		b[i] ^= t;
+	}
+}
+
+/* a^(p-2), see fe51_invert */
+static void fe64_invert(fe64 o, const fe64 z)
+{
+#ifdef HAVE_SAFEGCD
+	uint8_t b[32];
+
+	fe64_tobytes(b, z);
+	x25519_invert_safegcd(b, b);
+	fe64_frombytes(o, b);
+#else
+	fe64 z2, z9, z11, z2_5_0, z2_10_0, z2_20_0, z2_50_0, z2_100_0, t;
+
+	fe64_sq(z2, z);
+	fe64_sq_n(t, z2, 2);
+	fe64_mul(z9, t, z);
+	fe64_mul(z11, z9, z2);
+	fe64_sq(t, z11);
+	fe64_mul(z2_5_0, t, z9);
+	fe64_sq_n(t, z2_5_0, 5);
+	fe64_mul(z2_10_0, t, z2_5_0);
+	fe64_sq_n(t, z2_10_0, 10);
+	fe64_mul(z2_20_0, t, z2_10_0);
+	fe64_sq_n(t, z2_20_0, 20);
+	fe64_mul(t, t, z2_20_0);
+	fe64_sq_n(t, t, 10);
+	fe64_mul(z2_50_0, t, z2_10_0);
+	fe64_sq_n(t, z2_50_0, 50);
+	fe64_mul(z2_100_0, t, z2_50_0);
+	fe64_sq_n(t, z2_100_0, 100);
+	fe64_mul(t, t, z2_100_0);
+	fe64_sq_n(t, t, 50);
+	fe64_mul(t, t, z2_50_0);
+	fe64_sq_n(t, t, 5);
+	fe64_mul(o, t, z11);
+#endif
+}
+
+/* Montgomery ladder, RFC7748 Section 5 */
+int crypto_scalarmult_mulx(uint8_t *q, const uint8_t *n, const uint8_t *p)
+{
+	uint8_t e[32];
+	memcpy(e, n, 32);
+	e[0] &= 248;
+	e[31] = (e[31] & 127) | 64;
+
+	fe64 x1, x2 = {1}, z2 = {0}, x3, z3 = {1};
+	fe64 a, aa, b, bb, c, d, da, cb, t;
+
+	fe64_frombytes(x1, p);
+	memcpy(x3, x1, sizeof(x3));
+
+	uint64_t swap = 0;
+	for (int i = 254; i >= 0; i--) {
+		uint64_t bit = (e[i >> 3] >> (i & 7)) & 1;
+
+		swap ^= bit;
+		fe64_cswap(x2, x3, swap);
+		fe64_cswap(z2, z3, swap);
+		swap = bit;
+
+		fe64_add(a, x2, z2);
+		fe64_sub(b, x2, z2);
+		fe64_add(c, x3, z3);
+		fe64_sub(d, x3, z3);
+		fe64_sq(aa, a);
+		fe64_sq(bb, b);
+		fe64_mul(da, d, a);
+		fe64_mul(cb, c, b);
+
+		fe64_add(t, da, cb);
+		fe64_sq(x3, t);
+		fe64_sub(t, da, cb);
+		fe64_sq(t, t);
+		fe64_mul(z3, t, x1);
+
+		fe64_mul(x2, aa, bb);
+		fe64_sub(t, aa, bb);
+		fe64_mul_121665(a, t);
+		fe64_add(a, a, aa);
+		fe64_mul(z2, t, a);
+	}
+
+	fe64_cswap(x2, x3, swap);
+	fe64_cswap(z2, z3, swap);
+
+	fe64_invert(z2, z2);
+	fe64_mul(x2, x2, z2);
+	fe64_tobytes(q, x2);
+
+	wipe_sized(e);
+	wipe_sized(x2);
+	wipe_sized(z2);
+	wipe_sized(x3);
+	wipe_sized(z3);
+
+	return 0;
+}
@@ -0,0 +1,430 @@
+// 4-way X25519 with AVX2
+//
+// Runs four Montgomery ladders with the same scalar in the four 64 bit lanes
+// of AVX2 registers. Field elements use ten limbs of alternating 26 and 25
+// bits (radix 2^25.5), limb i of all four elements is stored in one register
+// so that vpmuludq computes four 32x32->64 bit limb products at once.
+//
+// Limbs are unsigned. As for the radix-2^51 backend, only multiplications and
+// squarings carry, subtractions add 2p and thus need a normalized second
+// operand. Every operand of a multiplication stays below 3 * 2^26 (even limbs)
+// and 3 * 2^25 (odd limbs), so that 19 times a limb still fits into the 32 bit
+// multiplier input and sums of products fit into 64 bits.
+//
+// Only built for x86-64 (HAVE_AVX2), the functions are compiled for AVX2 via
+// target attributes, crypto_scalarmult_batch only calls them on CPUs that
+// support it, see x25519_dispatch.
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+#include "utils.h"
+
+#include "x25519.h"
+
+#define AVX2 __attribute__((target("avx2")))
+
+typedef struct {
+	__m256i v[10];
+} fe4;
+
+static const uint8_t limb_bits[10] = { 26, 25, 26, 25, 26, 25, 26, 25, 26, 25 };
+static const uint8_t limb_start[10] = { 0, 26, 51, 77, 102, 128, 153, 179, 204, 230 };
+
+static void fe25_frombytes(uint64_t h[10], const uint8_t *s)
+{
+	uint8_t buf[40] = {0};
+	memcpy(buf, s, 32);
+	buf[31] &= 127;
+
+	for (int i = 0; i < 10; i++) {
+		uint64_t w = unp64le(buf + limb_start[i] / 8);
+		h[i] = (w >> (limb_start[i] % 8)) & ((UINT64_C(1) << limb_bits[i]) - 1);
+	}
+}
+
+static void fe25_carry(uint64_t h[10])
+{
+	for (int i = 0; i < 9; i++) {
+		h[i+1] += h[i] >> limb_bits[i];
+		h[i] &= (UINT64_C(1) << limb_bits[i]) - 1;
+	}
+
+	h[0] += 19 * (h[9] >> 25);
+	h[9] &= (UINT64_C(1) << 25) - 1;
+}
+
+static void fe25_tobytes(uint8_t *s, const uint64_t in[10])
+{
+	uint64_t h[10];
+	memcpy(h, in, sizeof(h));
+
+	fe25_carry(h);
+	fe25_carry(h);
+
+	// h < 2^255 + 19 now, subtract p iff h + 19 overflows 2^255
+	uint64_t q = (h[0] + 19) >> 26;
+	for (int i = 1; i < 10; i++)
+		q = (h[i] + q) >> limb_bits[i];
+
+	h[0] += 19 * q;
+	for (int i = 0; i < 9; i++) {
+		h[i+1] += h[i] >> limb_bits[i];
+		h[i] &= (UINT64_C(1) << limb_bits[i]) - 1;
+	}
+	h[9] &= (UINT64_C(1) << 25) - 1;
+
+	uint64_t acc = 0;
+	unsigned int acc_bits = 0, j = 0;
+	for (int i = 0; i < 10; i++) {
+		acc |= h[i] << acc_bits;
+		acc_bits += limb_bits[i];
+
+		while (acc_bits >= 8) {
+			s[j++] = acc & 0xff;
+			acc >>= 8;
+			acc_bits -= 8;
+		}
+	}
+	s[j] = acc;
+}
+
+static AVX2 void fe4_load(fe4 *o, const uint64_t h[4][10])
+{
+	for (int i = 0; i < 10; i++)
+		o->v[i] = _mm256_set_epi64x(h[3][i], h[2][i], h[1][i], h[0][i]);
+}
+
+static AVX2 void fe4_store(uint64_t h[4][10], const fe4 *a)
+{
+	for (int i = 0; i < 10; i++) {
+		uint64_t lanes[4];
+
+		_mm256_storeu_si256((__m256i*)lanes, a->v[i]);
+		for (int k = 0; k < 4; k++)
+			h[k][i] = lanes[k];
+	}
+}
+
+static AVX2 void fe4_set_small(fe4 *o, uint64_t x)
+{
+	o->v[0] = _mm256_set1_epi64x(x);
+	for (int i = 1; i < 10; i++)
+		o->v[i] = _mm256_setzero_si256();
+}
+
+static AVX2 void fe4_add(fe4 *o, const fe4 *a, const fe4 *b)
+{
+	for (int i = 0; i < 10; i++)
+		o->v[i] = _mm256_add_epi64(a->v[i], b->v[i]);
+}
+
+static AVX2 void fe4_sub(fe4 *o, const fe4 *a, const fe4 *b)
+{
+	// 2p
+	o->v[0] = _mm256_sub_epi64(_mm256_add_epi64(a->v[0], _mm256_set1_epi64x(0x7ffffda)), b->v[0]);
+	for (int i = 1; i < 10; i++) {
+		__m256i two_p = _mm256_set1_epi64x((i & 1) ? 0x3fffffe : 0x7fffffe);
+
+		o->v[i] = _mm256_sub_epi64(_mm256_add_epi64(a->v[i], two_p), b->v[i]);
+	}
+}
+
+static AVX2 __m256i mul19(__m256i x)
+{
+	return _mm256_add_epi64(x, _mm256_add_epi64(_mm256_slli_epi64(x, 1), _mm256_slli_epi64(x, 4)));
+}
+
+static AVX2 void fe4_carry(fe4 *o, __m256i h[10])
+{
+	const __m256i mask26 = _mm256_set1_epi64x((1 << 26) - 1);
+	const __m256i mask25 = _mm256_set1_epi64x((1 << 25) - 1);
+
+#pragma GCC unroll 9
+	for (int i = 0; i < 9; i++) {
+		if (i & 1) {
+			h[i+1] = _mm256_add_epi64(h[i+1], _mm256_srli_epi64(h[i], 25));
+			h[i] = _mm256_and_si256(h[i], mask25);
+		} else {
+			h[i+1] = _mm256_add_epi64(h[i+1], _mm256_srli_epi64(h[i], 26));
+			h[i] = _mm256_and_si256(h[i], mask26);
+		}
+	}
+
+	h[0] = _mm256_add_epi64(h[0], mul19(_mm256_srli_epi64(h[9], 25)));
+	h[9] = _mm256_and_si256(h[9], mask25);
+
+	h[1] = _mm256_add_epi64(h[1], _mm256_srli_epi64(h[0], 26));
+	h[0] = _mm256_and_si256(h[0], mask26);
+
+#pragma GCC unroll 10
+	for (int i = 0; i < 10; i++)
+		o->v[i] = h[i];
+}
+
+static AVX2 void fe4_mul(fe4 *o, const fe4 *f, const fe4 *g)
+{
+	__m256i f2[10], g19[10], h[10];
+
+#pragma GCC unroll 10
+	for (int i = 0; i < 10; i++) {
+		f2[i] = _mm256_add_epi64(f->v[i], f->v[i]);
+		g19[i] = _mm256_mul_epu32(g->v[i], _mm256_set1_epi64x(19));
+		h[i] = _mm256_setzero_si256();
+	}
+
+	// products of two odd limbs carry an extra factor of two, products
+	// wrapping around 2^255 an extra factor of 19
+#pragma GCC unroll 10
+	for (int i = 0; i < 10; i++) {
+#pragma GCC unroll 10
+		for (int j = 0; j < 10; j++) {
+			__m256i a = (i & j & 1) ? f2[i] : f->v[i];
+
+			if (i + j < 10)
+				h[i+j] = _mm256_add_epi64(h[i+j], _mm256_mul_epu32(a, g->v[j]));
+			else
+				h[i+j-10] = _mm256_add_epi64(h[i+j-10], _mm256_mul_epu32(a, g19[j]));
+		}
+	}
+
+	fe4_carry(o, h);
+}
+
+static AVX2 void fe4_sq(fe4 *o, const fe4 *f)
+{
+	__m256i f2[10], f4[10], f19[10], h[10];
+
+#pragma GCC unroll 10
+	for (int i = 0; i < 10; i++) {
+		f2[i] = _mm256_add_epi64(f->v[i], f->v[i]);
+		f4[i] = _mm256_add_epi64(f2[i], f2[i]);
+		f19[i] = _mm256_mul_epu32(f->v[i], _mm256_set1_epi64x(19));
+		h[i] = _mm256_setzero_si256();
+	}
+
+	// as in fe4_mul, with the products f_i f_j and f_j f_i combined
+#pragma GCC unroll 10
+	for (int i = 0; i < 10; i++) {
+#pragma GCC unroll 10
+		for (int j = i; j < 10; j++) {
+			__m256i a;
+
+			if (i == j)
+				a = (i & 1) ? f2[i] : f->v[i];
+			else
+				a = (i & j & 1) ? f4[i] : f2[i];
+
+			if (i + j < 10)
+				h[i+j] = _mm256_add_epi64(h[i+j], _mm256_mul_epu32(a, f->v[j]));
+			else
+				h[i+j-10] = _mm256_add_epi64(h[i+j-10], _mm256_mul_epu32(a, f19[j]));
+		}
+	}
+
+	fe4_carry(o, h);
+}
+
+static AVX2 void fe4_mul_121665(fe4 *o, const fe4 *f)
+{
+	__m256i h[10];
+
+#pragma GCC unroll 10
+	for (int i = 0; i < 10; i++)
+		h[i] = _mm256_mul_epu32(f->v[i], _mm256_set1_epi64x(121665));
+
+	fe4_carry(o, h);
+}
+
+static AVX2 void fe4_cswap(fe4 *a, fe4 *b, uint64_t swap)
+{
+	__m256i mask = _mm256_set1_epi64x(-swap);
+
+	for (int i = 0; i < 10; i++) {
+		__m256i t = _mm256_and_si256(mask, _mm256_xor_si256(a->v[i], b->v[i]));
+
+		a->v[i] = _mm256_xor_si256(a->v[i], t);
+		b->v[i] = _mm256_xor_si256(b->v[i], t);
+	}
+}
+
+static AVX2 void fe4_sq_n(fe4 *o, const fe4 *a, int n)
+{
+	fe4_sq(o, a);
+	while (--n)
+		fe4_sq(o, o);
+}
+
+static AVX2 void fe4_invert(fe4 *o, const fe4 *z)
+{
+	fe4 z2, z9, z11, z2_5_0, z2_10_0, z2_20_0, z2_50_0, z2_100_0, t;
+
+	fe4_sq(&z2, z);
+	fe4_sq_n(&t, &z2, 2);
+	fe4_mul(&z9, &t, z);
+	fe4_mul(&z11, &z9, &z2);
+	fe4_sq(&t, &z11);
+	fe4_mul(&z2_5_0, &t, &z9);
+	fe4_sq_n(&t, &z2_5_0, 5);
+	fe4_mul(&z2_10_0, &t, &z2_5_0);
+	fe4_sq_n(&t, &z2_10_0, 10);
+	fe4_mul(&z2_20_0, &t, &z2_10_0);
+	fe4_sq_n(&t, &z2_20_0, 20);
+	fe4_mul(&t, &t, &z2_20_0);
+	fe4_sq_n(&t, &t, 10);
+	fe4_mul(&z2_50_0, &t, &z2_10_0);
+	fe4_sq_n(&t, &z2_50_0, 50);
+	fe4_mul(&z2_100_0, &t, &z2_50_0);
+	fe4_sq_n(&t, &z2_100_0, 100);
+	fe4_mul(&t, &t, &z2_100_0);
+	fe4_sq_n(&t, &t, 50);
+	fe4_mul(&t, &t, &z2_50_0);
+	fe4_sq_n(&t, &t, 5);
+	fe4_mul(o, &t, &z11);
+}
+
+static AVX2 void fe4_cmov(fe4 *a, const fe4 *b, __m256i mask)
+{
+	for (int i = 0; i < 10; i++)
+		a->v[i] = _mm256_xor_si256(a->v[i], _mm256_and_si256(mask, _mm256_xor_si256(a->v[i], b->v[i])));
+}
+
+// all-ones in the lanes where a is zero mod p
+static AVX2 __m256i fe4_iszero(const fe4 *a)
+{
+	uint64_t h[4][10], zero[4];
+
+	fe4_store(h, a);
+	for (int k = 0; k < 4; k++) {
+		uint8_t s[32], acc = 0;
+
+		fe25_tobytes(s, h[k]);
+		for (int i = 0; i < 32; i++)
+			acc |= s[i];
+
+		zero[k] = -(((uint64_t)acc - 1) >> 63);
+	}
+
+	return _mm256_loadu_si256((const __m256i*)zero);
+}
+
+static AVX2 void fe4_ladder(fe4 *x2, fe4 *z2, const fe4 *x1, const uint8_t e[32])
+{
+	fe4 x3, z3;
+	fe4 a, aa, b, bb, c, d, da, cb, t;
+
+	fe4_set_small(x2, 1);
+	fe4_set_small(z2, 0);
+	x3 = *x1;
+	fe4_set_small(&z3, 1);
+
+	uint64_t swap = 0;
+	for (int i = 254; i >= 0; i--) {
+		uint64_t bit = (e[i >> 3] >> (i & 7)) & 1;
+
+		swap ^= bit;
+		fe4_cswap(x2, &x3, swap);
+		fe4_cswap(z2, &z3, swap);
+		swap = bit;
+
+		fe4_add(&a, x2, z2);
+		fe4_sub(&b, x2, z2);
+		fe4_add(&c, &x3, &z3);
+		fe4_sub(&d, &x3, &z3);
+		fe4_sq(&aa, &a);
+		fe4_sq(&bb, &b);
+		fe4_mul(&da, &d, &a);
+		fe4_mul(&cb, &c, &b);
+
+		fe4_add(&t, &da, &cb);
+		fe4_sq(&x3, &t);
+		fe4_sub(&t, &da, &cb);
+		fe4_sq(&t, &t);
+		fe4_mul(&z3, &t, x1);
+
+		fe4_mul(x2, &aa, &bb);
+		fe4_sub(&t, &aa, &bb);
+		fe4_mul_121665(&a, &t);
+		fe4_add(&a, &a, &aa);
+		fe4_mul(z2, &t, &a);
+	}
+
+	fe4_cswap(x2, &x3, swap);
+	fe4_cswap(z2, &z3, swap);
+
+	wipe_sized(x3);
+	wipe_sized(z3);
+}
+
+// number of four point groups normalized with a single inversion
+#define GROUP_BATCH 4
+
+AVX2 int crypto_scalarmult_avx2x4(uint8_t *q, const uint8_t *n, const uint8_t *p, size_t groups)
+{
+	uint8_t e[32];
+	memcpy(e, n, 32);
+	e[0] &= 248;
+	e[31] = (e[31] & 127) | 64;
+
+	fe4 x1, one, zero, inv, zinv;
+	fe4 x2[GROUP_BATCH], z2[GROUP_BATCH], prod[GROUP_BATCH];
+	uint64_t h[4][10];
+
+	fe4_set_small(&one, 1);
+	fe4_set_small(&zero, 0);
+
+	while (groups) {
+		int m = groups < GROUP_BATCH ? groups : GROUP_BATCH;
+
+		for (int g = 0; g < m; g++) {
+			for (int k = 0; k < 4; k++)
+				fe25_frombytes(h[k], p + 128 * g + 32 * k);
+
+			fe4_load(&x1, (const uint64_t (*)[10])h);
+			fe4_ladder(&x2[g], &z2[g], &x1, e);
+
+			// as for fe51_div_batch, zero denominators must not spoil
+			// the shared inversion
+			__m256i is_zero = fe4_iszero(&z2[g]);
+			fe4_cmov(&x2[g], &zero, is_zero);
+			fe4_cmov(&z2[g], &one, is_zero);
+
+			if (g > 0)
+				fe4_mul(&prod[g], &prod[g-1], &z2[g]);
+			else
+				prod[0] = z2[0];
+		}
+
+		fe4_invert(&inv, &prod[m-1]);
+
+		for (int g = m - 1; g >= 0; g--) {
+			if (g > 0) {
+				fe4_mul(&zinv, &inv, &prod[g-1]);
+				fe4_mul(&inv, &inv, &z2[g]);
+			} else {
+				zinv = inv;
+			}
+
+			fe4_mul(&zinv, &zinv, &x2[g]);
+
+			fe4_store(h, &zinv);
+			for (int k = 0; k < 4; k++)
+				fe25_tobytes(q + 128 * g + 32 * k, h[k]);
+		}
+
+		q += 128 * m;
+		p += 128 * m;
+		groups -= m;
+	}
+
+	wipe_sized(e);
+	wipe_sized(x2);
+	wipe_sized(z2);
+	wipe_sized(prod);
+	wipe_sized(inv);
+	wipe_sized(zinv);
+	wipe_sized(h);
+
+	return 0;
+}
@@ -0,0 +1,224 @@
+// Constant-time field inversion via safegcd
+//
+// Computes a^-1 mod p = 2^255 - 19 with the divsteps algorithm of Bernstein
+// and Yang[1], following the constant-time variant in libsecp256k1[2]
+// (modinv32). Numbers are stored as nine signed 30 bit limbs, so only
+// 32x32->64 bit products are needed and the code is fast on 32 bit targets
+// too.
+//
+// 20 batches of 30 divsteps each are run, which is enough for any 256 bit
+// modulus. Every batch is applied to f, g and d, e as a 2x2 transition matrix
+// scaled by 2^30, d is kept congruent to the inverse (times a power of two
+// that is cancelled by the modular division in update_de).
+//
+// [1] Bernstein, Daniel J., and Bo-Yin Yang. "Fast constant-time gcd
+//     computation and modular inversion." TCHES 2019.3 (2019): 340-398.
+// [2] https://github.com/bitcoin-core/secp256k1/blob/master/doc/safegcd_implementation.md
+
+#include <stdint.h>
+
+#include "utils.h"
+
+#include "x25519.h"
+
+#define M30 ((int32_t)(UINT32_MAX >> 2))
+
+typedef struct {
+	int32_t v[9];
+} signed30;
+
+struct trans2x2 {
+	int32_t u, v, q, r;
+};
+
+// p = 2^255 - 19
+static const signed30 modulus = {{
+	0x3fffffed, 0x3fffffff, 0x3fffffff, 0x3fffffff, 0x3fffffff,
+	0x3fffffff, 0x3fffffff, 0x3fffffff, 0x7fff
+}};
+
+// p^-1 mod 2^30
+static const uint32_t modulus_inv30 = 0x179435e5;
+
+/* Runs 30 divsteps on the low bits of f and g. zeta is -(delta + 1/2), the
+ * returned matrix t satisfies [f', g'] = t [f, g] / 2^30. */
+static int32_t divsteps_30(int32_t zeta, uint32_t f0, uint32_t g0, struct trans2x2 *t)
+{
+	uint32_t u = 1, v = 0, q = 0, r = 1;
+	uint32_t f = f0, g = g0;
+
+	for (int i = 0; i < 30; i++) {
+		// mask1 is all-ones if zeta < 0 (delta > 0), mask2 if g is odd
+		uint32_t mask1 = (uint32_t)(zeta >> 31);
+		uint32_t mask2 = -(g & 1);
+
+		// conditionally negate f, u, v and add them to g, q, r
+		uint32_t x = (f ^ mask1) - mask1;
+		uint32_t y = (u ^ mask1) - mask1;
+		uint32_t z = (v ^ mask1) - mask1;
+
+		g += x & mask2;
+		q += y & mask2;
+		r += z & mask2;
+
+		// swap if delta > 0 and g was odd: f += g, u += q, v += r then
+		// holds the old values of g, q and r
+		mask1 &= mask2;
+		zeta = (zeta ^ (int32_t)mask1) - 1;
+
+		f += g & mask1;
+		u += q & mask1;
+		v += r & mask1;
+
+		g >>= 1;
+		u <<= 1;
+		v <<= 1;
+	}
+
+	t->u = (int32_t)u;
+	t->v = (int32_t)v;
+	t->q = (int32_t)q;
+	t->r = (int32_t)r;
+
+	return zeta;
+}
+
+/* [d, e] = t [d, e] / 2^30 mod p, keeping both in (-2p, p) */
+static void update_de_30(signed30 *d, signed30 *e, const struct trans2x2 *t)
+{
+	const int32_t u = t->u, v = t->v, q = t->q, r = t->r;
+
+	// add u, q if d is negative and v, r if e is negative
+	int32_t sd = d->v[8] >> 31;
+	int32_t se = e->v[8] >> 31;
+	int32_t md = (u & sd) + (v & se);
+	int32_t me = (q & sd) + (r & se);
+
+	int64_t cd = (int64_t)u * d->v[0] + (int64_t)v * e->v[0];
+	int64_t ce = (int64_t)q * d->v[0] + (int64_t)r * e->v[0];
+
+	// choose md, me such that adding md * p, me * p clears the low 30 bits
+	md -= (modulus_inv30 * (uint32_t)cd + md) & M30;
+	me -= (modulus_inv30 * (uint32_t)ce + me) & M30;
+
+	cd += (int64_t)modulus.v[0] * md;
+	ce += (int64_t)modulus.v[0] * me;
+	cd >>= 30;
+	ce >>= 30;
+
+	for (int i = 1; i < 9; i++) {
+		cd += (int64_t)u * d->v[i] + (int64_t)v * e->v[i];
+		ce += (int64_t)q * d->v[i] + (int64_t)r * e->v[i];
+		cd += (int64_t)modulus.v[i] * md;
+		ce += (int64_t)modulus.v[i] * me;
+
+		d->v[i-1] = (int32_t)cd & M30;
+		e->v[i-1] = (int32_t)ce & M30;
+		cd >>= 30;
+		ce >>= 30;
+	}
+
+	d->v[8] = (int32_t)cd;
+	e->v[8] = (int32_t)ce;
+}
+
+/* [f, g] = t [f, g] / 2^30, the division is exact */
+static void update_fg_30(signed30 *f, signed30 *g, const struct trans2x2 *t)
+{
+	const int32_t u = t->u, v = t->v, q = t->q, r = t->r;
+
+	int64_t cf = (int64_t)u * f->v[0] + (int64_t)v * g->v[0];
+	int64_t cg = (int64_t)q * f->v[0] + (int64_t)r * g->v[0];
+	cf >>= 30;
+	cg >>= 30;
+
+	for (int i = 1; i < 9; i++) {
+		cf += (int64_t)u * f->v[i] + (int64_t)v * g->v[i];
+		cg += (int64_t)q * f->v[i] + (int64_t)r * g->v[i];
+
+		f->v[i-1] = (int32_t)cf & M30;
+		g->v[i-1] = (int32_t)cg & M30;
+		cf >>= 30;
+		cg >>= 30;
+	}
+
+	f->v[8] = (int32_t)cf;
+	g->v[8] = (int32_t)cg;
+}
+
+static void propagate_30(signed30 *r)
+{
+	for (int i = 0; i < 8; i++) {
+		r->v[i+1] += r->v[i] >> 30;
+		r->v[i] &= M30;
+	}
+}
+
+/* Maps r from (-2p, p) to [0, p) and negates it if sign is negative */
+static void normalize_30(signed30 *r, int32_t sign)
+{
+	int32_t cond_add = r->v[8] >> 31;
+	int32_t cond_negate = sign >> 31;
+
+	for (int i = 0; i < 9; i++) {
+		r->v[i] += modulus.v[i] & cond_add;
+		r->v[i] = (r->v[i] ^ cond_negate) - cond_negate;
+	}
+	propagate_30(r);
+
+	cond_add = r->v[8] >> 31;
+	for (int i = 0; i < 9; i++)
+		r->v[i] += modulus.v[i] & cond_add;
+	propagate_30(r);
+}
+
+void x25519_invert_safegcd(uint8_t out[32], const uint8_t in[32])
+{
+	signed30 d = {{0}}, e = {{1}}, f = modulus, g = {{0}};
+	int32_t zeta = -1;
+	uint64_t acc = 0;
+	int bits = 0, j = 0;
+
+	for (int i = 0; i < 32; i++) {
+		acc |= (uint64_t)in[i] << bits;
+		bits += 8;
+
+		if (bits >= 30) {
+			g.v[j++] = acc & M30;
+			acc >>= 30;
+			bits -= 30;
+		}
+	}
+	g.v[j] = acc;
+
+	for (int i = 0; i < 20; i++) {
+		struct trans2x2 t;
+
+		zeta = divsteps_30(zeta, f.v[0], g.v[0], &t);
+		update_de_30(&d, &e, &t);
+		update_fg_30(&f, &g, &t);
+	}
+
+	// f = gcd(a, p) = +-1 now (or a = 0, then d = 0 as well)
+	normalize_30(&d, f.v[8]);
+
+	acc = 0;
+	bits = 0;
+	j = 0;
+	for (int i = 0; i < 9; i++) {
+		acc |= (uint64_t)d.v[i] << bits;
+		bits += 30;
+
+		while (bits >= 8 && j < 32) {
+			out[j++] = acc & 0xff;
+			acc >>= 8;
+			bits -= 8;
+		}
+	}
+
+	wipe_sized(d);
+	wipe_sized(e);
+	wipe_sized(f);
+	wipe_sized(g);
+	wipe_sized(acc);
+}